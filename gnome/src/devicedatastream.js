@@ -3,43 +3,36 @@ import GObject from 'gi://GObject';
 
 import Globals from './globals.js';
 import { 
-    dataViewEnd,
     dataViewUint8,
     dataViewBigUint,
     dataViewUint32Array,
     dataViewUint8Array,
     dataViewFloat,
-    dataViewFloatArray,
-    BOOL_SIZE,
-    FLOAT_SIZE,
-    UINT_SIZE,
-    UINT8_SIZE
+    dataViewFloatArray
 } from "./ipc.js";
+import {
+    DATA_LAYOUT_VERSION,
+    VERSION,
+    ENABLED,
+    LOOK_AHEAD_CFG,
+    DISPLAY_RES,
+    DISPLAY_FOV,
+    LENS_DISTANCE_RATIO,
+    SBS_ENABLED,
+    CUSTOM_BANNER_ENABLED,
+    SMOOTH_FOLLOW_ENABLED,
+    SMOOTH_FOLLOW_ORIGIN_DATA,
+    POSE_POSITION,
+    EPOCH_MS,
+    POSE_ORIENTATION,
+    IMU_PARITY_BYTE,
+    DATA_VIEW_LENGTH
+} from "./imulayout.js";
 import { isValidKeepAlive, getEpochSec, toSec } from "./time.js";
 
 const IPC_FILE_PATH = "/dev/shm/breezy_desktop_imu";
 const KEEPALIVE_REFRESH_INTERVAL_SEC = 1;
 
-// the driver should be using the same data layout version
-const DATA_LAYOUT_VERSION = 5;
-
-// DataView info: [offset, size, count]
-const VERSION = [0, UINT8_SIZE, 1];
-const ENABLED = [dataViewEnd(VERSION), BOOL_SIZE, 1];
-const LOOK_AHEAD_CFG = [dataViewEnd(ENABLED), FLOAT_SIZE, 4];
-const DISPLAY_RES = [dataViewEnd(LOOK_AHEAD_CFG), UINT_SIZE, 2];
-const DISPLAY_FOV = [dataViewEnd(DISPLAY_RES), FLOAT_SIZE, 1];
-const LENS_DISTANCE_RATIO = [dataViewEnd(DISPLAY_FOV), FLOAT_SIZE, 1];
-const SBS_ENABLED = [dataViewEnd(LENS_DISTANCE_RATIO), BOOL_SIZE, 1];
-const CUSTOM_BANNER_ENABLED = [dataViewEnd(SBS_ENABLED), BOOL_SIZE, 1];
-const SMOOTH_FOLLOW_ENABLED = [dataViewEnd(CUSTOM_BANNER_ENABLED), BOOL_SIZE, 1];
-const SMOOTH_FOLLOW_ORIGIN_DATA = [dataViewEnd(SMOOTH_FOLLOW_ENABLED), FLOAT_SIZE, 16];
-const POSE_POSITION = [dataViewEnd(SMOOTH_FOLLOW_ORIGIN_DATA), FLOAT_SIZE, 3];
-const EPOCH_MS = [dataViewEnd(POSE_POSITION), UINT_SIZE, 2];
-const POSE_ORIENTATION = [dataViewEnd(EPOCH_MS), FLOAT_SIZE, 16];
-const IMU_PARITY_BYTE = [dataViewEnd(POSE_ORIENTATION), UINT8_SIZE, 1];
-const DATA_VIEW_LENGTH = dataViewEnd(IMU_PARITY_BYTE);
-
 function checkParityByte(dataView) {
     const parityByte = dataViewUint8(dataView, IMU_PARITY_BYTE);
     let parity = 0;
@@ -0,0 +1,22 @@
+// Generated from kwin/src/imulayout/imulayout.h by breezy_imu_layout_js, do not edit.
+// Rebuild the update_gnome_imu_layout target after changing the layout.
+
+// the driver should be using the same data layout version
+export const DATA_LAYOUT_VERSION = 5;
+
+// DataView info: [offset, size, count]
+export const VERSION = [0, 1, 1];
+export const ENABLED = [1, 1, 1];
+export const LOOK_AHEAD_CFG = [2, 4, 4];
+export const DISPLAY_RES = [18, 4, 2];
+export const DISPLAY_FOV = [26, 4, 1];
+export const LENS_DISTANCE_RATIO = [30, 4, 1];
+export const SBS_ENABLED = [34, 1, 1];
+export const CUSTOM_BANNER_ENABLED = [35, 1, 1];
+export const SMOOTH_FOLLOW_ENABLED = [36, 1, 1];
+export const SMOOTH_FOLLOW_ORIGIN_DATA = [37, 4, 16];
+export const POSE_POSITION = [101, 4, 3];
+export const EPOCH_MS = [113, 4, 2];
+export const POSE_ORIENTATION = [121, 4, 16];
+export const IMU_PARITY_BYTE = [185, 1, 1];
+export const DATA_VIEW_LENGTH = 186;
@@ -1,4 +1,6 @@
 #include "core/output.h"
+#include "core/outputconfiguration.h"
+#include "core/renderloop.h"
 #include "core/rendertarget.h"
 #include "core/renderviewport.h"
 #include "cursor.h"
@@ -7,9 +9,15 @@
 #include "kcm/shortcuts.h"
 #include "breezydesktopeffect.h"
 #include "breezydesktopconfig.h"
+#include "configwriter.h"
 #include "effect/effect.h"
 #include "effect/effecthandler.h"
+#include "effect/effectwindow.h"
+#include "gpupasstimer.h"
+#include "motiontophoton.h"
 #include "opengl/glutils.h"
+#include "posereader.h"
+#include "workspace.h"
 #include "xrdriveripc.h"
 
 #include <kwin/main.h>
@@ -21,17 +29,22 @@
 #include <QFile>
 #include <QFileSystemWatcher>
 #include <QJsonArray>
+#include <QJsonDocument>
 #include <QJsonObject>
 #include <QLoggingCategory>
+#include <QQmlEngine>
 #include <QQuickItem>
 #include <QTimer>
 #include <QDBusConnection>
+#include <QDir>
 #include <QDateTime>
 
 #include <KGlobalAccel>
 #include <KLocalizedString>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 
 Q_LOGGING_CATEGORY(KWIN_XR, "kwin.xr")
 
@@ -44,76 +57,115 @@ class BreezyDesktopDBusAdaptor : public QObject {
     Q_CLASSINFO("D-Bus Interface", "com.xronlinux.BreezyDesktop")
 public:
     explicit BreezyDesktopDBusAdaptor(KWin::BreezyDesktopEffect *effect)
-        : QObject(effect), m_effect(effect) {}
+        : QObject(effect), m_effect(effect) {
+        BreezyVirtualDisplays::registerDBusTypes();
+        connect(effect, &KWin::BreezyDesktopEffect::virtualDisplaysChanged, this, [this]() {
+            Q_EMIT VirtualDisplaysChanged(m_effect->listVirtualDisplays());
+        });
+        const auto publishPose = [this]() {
+            Q_EMIT PoseChanged(m_effect->poseState());
+        };
+        connect(effect, &KWin::BreezyDesktopEffect::posePublished, this, publishPose);
+        connect(effect, &KWin::BreezyDesktopEffect::enabledStateChanged, this, publishPose);
+        connect(effect, &KWin::BreezyDesktopEffect::poseResetStateChanged, this, publishPose);
+    }
+
+Q_SIGNALS:
+    // carries the full list so listeners never need a follow-up ListVirtualDisplays call
+    void VirtualDisplaysChanged(const BreezyVirtualDisplays::VirtualDisplayInfoList &displays);
+
+    // at most 10 times a second while the driver is writing poses, plus whenever enabled or reset state changes
+    void PoseChanged(const QVariantMap &pose);
 
 public Q_SLOTS:
-    QVariantList AddVirtualDisplay(int width, int height) {
+    BreezyVirtualDisplays::VirtualDisplayInfoList AddVirtualDisplay(int width, int height) {
         m_effect->addVirtualDisplay(QSize(width, height));
         return m_effect->listVirtualDisplays();
     }
 
-    QVariantList ListVirtualDisplays() const {
+    BreezyVirtualDisplays::VirtualDisplayInfoList AddVirtualDisplayWithMode(int width, int height, double scale) {
+        m_effect->addVirtualDisplay(QSize(width, height), scale);
+        return m_effect->listVirtualDisplays();
+    }
+
+    // ids in the argument are ignored, new displays always get the next free one
+    BreezyVirtualDisplays::VirtualDisplayInfoList AddVirtualDisplays(const BreezyVirtualDisplays::VirtualDisplayInfoList &displays) {
+        m_effect->addVirtualDisplays(displays);
         return m_effect->listVirtualDisplays();
     }
 
-    QVariantList RemoveVirtualDisplay(const QString &id) {
+    BreezyVirtualDisplays::VirtualDisplayInfoList ListVirtualDisplays() const {
+        return m_effect->listVirtualDisplays();
+    }
+
+    BreezyVirtualDisplays::VirtualDisplayInfoList RemoveVirtualDisplay(const QString &id) {
         m_effect->removeVirtualDisplay(id);
         return m_effect->listVirtualDisplays();
     }
 
+    QStringList ListVirtualDisplayLayouts() const {
+        return m_effect->virtualDisplayLayoutNames();
+    }
+
+    QString ActiveVirtualDisplayLayout() const {
+        return m_effect->activeVirtualDisplayLayout();
+    }
+
+    bool SaveVirtualDisplayLayout(const QString &name) {
+        return m_effect->saveVirtualDisplayLayout(name);
+    }
+
+    BreezyVirtualDisplays::VirtualDisplayInfoList RestoreVirtualDisplayLayout(const QString &name) {
+        m_effect->restoreVirtualDisplayLayout(name);
+        return m_effect->listVirtualDisplays();
+    }
+
+    bool RemoveVirtualDisplayLayout(const QString &name) {
+        return m_effect->removeVirtualDisplayLayout(name);
+    }
+
     bool CurvedDisplaySupported() {
         return m_effect->curvedDisplaySupported();
     }
 
+    QVariantMap RenderStats() const {
+        return m_effect->renderStats();
+    }
+
+    QVariantMap StartupProfile() const {
+        return m_effect->startupProfile();
+    }
+
+    QVariantMap Pose() const {
+        return m_effect->poseState();
+    }
+
+    // developerMode only; empty until frames have been presented with it on
+    QVariantMap MotionToPhoton() const {
+        return m_effect->motionToPhotonStats();
+    }
+
+    // an empty path writes to the state directory; returns the path written, or an empty string on failure
+    QString DumpMotionToPhoton(const QString &path) const {
+        return m_effect->writeMotionToPhotonCsv(path);
+    }
+
+    void ResetMotionToPhoton() {
+        m_effect->resetMotionToPhoton();
+    }
+
     private:
         KWin::BreezyDesktopEffect *m_effect;
     };
 } // namespace
 
-namespace DataView
-{
-    const QString SHM_DIR = QStringLiteral("/dev/shm");
-    const QString SHM_PATH = SHM_DIR + QStringLiteral("/breezy_desktop_imu");
-
-    // Helper constants and functions for shared memory buffer offsets
-    constexpr int UINT8_SIZE = sizeof(uint8_t);
-    constexpr int BOOL_SIZE = UINT8_SIZE;
-    constexpr int UINT_SIZE = sizeof(uint32_t);
-    constexpr int FLOAT_SIZE = sizeof(float);
-
-    // DataView info: [offset, size, count]
-    constexpr int OFFSET_INDEX = 0;
-    constexpr int SIZE_INDEX = 1;
-    constexpr int COUNT_INDEX = 2;
-
-    // Computes the end offset, exclusive
-    constexpr int dataViewEnd(const int info[3]) {
-        return info[OFFSET_INDEX] + info[SIZE_INDEX] * info[COUNT_INDEX];
-    }
-
-    constexpr int VERSION[3] = {0, UINT8_SIZE, 1};
-    constexpr int ENABLED[3] = {dataViewEnd(VERSION), BOOL_SIZE, 1};
-    constexpr int LOOK_AHEAD_CFG[3] = {dataViewEnd(ENABLED), FLOAT_SIZE, 4};
-    constexpr int DISPLAY_RES[3] = {dataViewEnd(LOOK_AHEAD_CFG), UINT_SIZE, 2};
-    constexpr int DISPLAY_FOV[3] = {dataViewEnd(DISPLAY_RES), FLOAT_SIZE, 1};
-    constexpr int LENS_DISTANCE_RATIO[3] = {dataViewEnd(DISPLAY_FOV), FLOAT_SIZE, 1};
-    constexpr int SBS_ENABLED[3] = {dataViewEnd(LENS_DISTANCE_RATIO), BOOL_SIZE, 1};
-    constexpr int CUSTOM_BANNER_ENABLED[3] = {dataViewEnd(SBS_ENABLED), BOOL_SIZE, 1};
-    constexpr int SMOOTH_FOLLOW_ENABLED[3] = {dataViewEnd(CUSTOM_BANNER_ENABLED), BOOL_SIZE, 1};
-    constexpr int SMOOTH_FOLLOW_ORIGIN_DATA[3] = {dataViewEnd(SMOOTH_FOLLOW_ENABLED), FLOAT_SIZE, 16};
-    constexpr int POSE_POSITION_DATA[3] = {dataViewEnd(SMOOTH_FOLLOW_ORIGIN_DATA), FLOAT_SIZE, 3};
-    constexpr int POSE_DATE_MS[3] = {dataViewEnd(POSE_POSITION_DATA), UINT_SIZE, 2};
-    constexpr int POSE_ORIENTATION_ENTRIES = 4;
-    constexpr int POSE_ORIENTATION_DATA[3] = {dataViewEnd(POSE_DATE_MS), FLOAT_SIZE, 4 * POSE_ORIENTATION_ENTRIES};
-    constexpr int POSE_PARITY_BYTE[3] = {dataViewEnd(POSE_ORIENTATION_DATA), UINT8_SIZE, 1};
-    constexpr int LENGTH = dataViewEnd(POSE_PARITY_BYTE);
-}
-
 namespace KWin
 {
 
 BreezyDesktopEffect::BreezyDesktopEffect()
 {
+    m_startupClock.start();
+
     const QByteArray sessionClass = qgetenv("XDG_SESSION_CLASS").toLower();
     if (sessionClass != "user") {
         m_sessionClassBlocked = true;
@@ -123,63 +175,61 @@ BreezyDesktopEffect::BreezyDesktopEffect()
 
     qCCritical(KWIN_XR) << "\t\t\tBreezy - constructor";
 
-    // safe to request on each load, acts as a no-op if already present
-    {
-        QJsonObject flags;
-        QJsonArray requested;
-        requested.append(QStringLiteral("productivity"));
-        requested.append(QStringLiteral("productivity_pro"));
-        flags.insert(QStringLiteral("request_features"), requested);
-        XRDriverIPC::instance().writeControlFlags(flags);
-    }
-    
-    qmlRegisterUncreatableType<BreezyDesktopEffect>("org.kde.kwin.effect.breezy_desktop", 1, 0, "BreezyDesktopEffect", QStringLiteral("BreezyDesktop cannot be created in QML"));
-
-    setupGlobalShortcut(
-        BreezyShortcuts::TOGGLE,
-        [this]() { this->toggle(); }
-    );
-    setupGlobalShortcut(
-        BreezyShortcuts::RECENTER,
-        [this]() { this->recenter(); }
-    );
-    setupGlobalShortcut(
-        BreezyShortcuts::TOGGLE_ZOOM_ON_FOCUS,
-        [this]() { 
-            this->setZoomOnFocusEnabled(!m_zoomOnFocusEnabled);
-        }
-    );
-    setupGlobalShortcut(
-        BreezyShortcuts::TOGGLE_FOLLOW_MODE,
-        [this]() { this->toggleSmoothFollow(); }
-    );
-    setupGlobalShortcut(
-        BreezyShortcuts::CURSOR_TO_FOCUSED_DISPLAY,
-        [this]() { this->moveCursorToFocusedDisplay(); }
-    );
-
-    connect(effects, &EffectsHandler::cursorShapeChanged, this, &BreezyDesktopEffect::updateCursorImage);
-    updateCursorImage();
+    // Everything that isn't needed to notice a device (the driver feature request, the cursor image and the
+    // QML scene) waits for ensureInitialized(), so the plugin costs next to nothing at compositor startup.
+    qint64 phaseStart = m_startupClock.nsecsElapsed();
+    m_configWriter = new ConfigWriter(BreezyDesktopConfig::self(), this);
     reconfigure(ReconfigureAll);
+    recordStartupPhase(QStringLiteral("config"), phaseStart);
+
+    // The toggle shortcut is how the driver gets enabled in the first place, so the shortcuts can't wait for a
+    // device; they're only pushed out of the constructor, to the first pass of the event loop.
+    QTimer::singleShot(0, this, [this]() {
+        const qint64 shortcutsStart = m_startupClock.nsecsElapsed();
+        setupGlobalShortcut(
+            BreezyShortcuts::TOGGLE,
+            [this]() { this->toggle(); }
+        );
+        setupGlobalShortcut(
+            BreezyShortcuts::RECENTER,
+            [this]() { this->recenter(); }
+        );
+        setupGlobalShortcut(
+            BreezyShortcuts::TOGGLE_ZOOM_ON_FOCUS,
+            [this]() { 
+                this->setZoomOnFocusEnabled(!m_zoomOnFocusEnabled);
+            }
+        );
+        setupGlobalShortcut(
+            BreezyShortcuts::TOGGLE_FOLLOW_MODE,
+            [this]() { this->toggleSmoothFollow(); }
+        );
+        setupGlobalShortcut(
+            BreezyShortcuts::CURSOR_TO_FOCUSED_DISPLAY,
+            [this]() { this->moveCursorToFocusedDisplay(); }
+        );
+        recordStartupPhase(QStringLiteral("shortcuts"), shortcutsStart);
+    });
 
-    setSource(QUrl::fromLocalFile(QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("kwin/effects/breezy_desktop/qml/main.qml"))));
+    phaseStart = m_startupClock.nsecsElapsed();
 
     // Monitor the IPC file for changes, even if it doesn't exist at startup
     m_shmDirectoryWatcher = new QFileSystemWatcher(this);
-    m_shmDirectoryWatcher->addPath(DataView::SHM_DIR);
+    m_shmDirectoryWatcher->addPath(BreezyPose::SHM_DIR);
 
     m_shmFileWatcher = new QFileSystemWatcher(this);
+    m_poseReader = std::make_unique<BreezyPose::PoseReader>();
 
     // Setup file watcher with recreation detection
     auto setupFileWatcher = [this]() {
-        if (QFile::exists(DataView::SHM_PATH) && (
+        if (QFile::exists(BreezyPose::SHM_PATH) && (
             m_poseTimestamp == 0 || 
             QDateTime::currentMSecsSinceEpoch() - m_poseTimestamp > 50 || // file may have been deleted and recreated
-            !m_shmFileWatcher->files().contains(DataView::SHM_PATH)
+            !m_shmFileWatcher->files().contains(BreezyPose::SHM_PATH)
         )) {
-            m_shmFileWatcher->removePath(DataView::SHM_PATH);
+            m_shmFileWatcher->removePath(BreezyPose::SHM_PATH);
             disconnect(m_shmFileWatcher, &QFileSystemWatcher::fileChanged, this, &BreezyDesktopEffect::updatePose);
-            m_shmFileWatcher->addPath(DataView::SHM_PATH);
+            m_shmFileWatcher->addPath(BreezyPose::SHM_PATH);
             connect(m_shmFileWatcher, &QFileSystemWatcher::fileChanged, this, &BreezyDesktopEffect::updatePose);
         }
     };
@@ -198,28 +248,42 @@ BreezyDesktopEffect::BreezyDesktopEffect()
     });
     m_watchdogTimer->start();
 
+    // not started here: the cursor position only matters once the scene is up
     m_cursorUpdateTimer = new QTimer(this);
     connect(m_cursorUpdateTimer, &QTimer::timeout, this, &BreezyDesktopEffect::updateCursorPos);
     m_cursorUpdateTimer->setInterval(16); // ~60Hz
-    m_cursorUpdateTimer->start();
+
+    m_gpuPassTimer = new GpuPassTimer(this);
+    connect(m_gpuPassTimer, &GpuPassTimer::frameTimed, this, [this](double totalMs) {
+        if (m_dynamicRenderScale) m_renderScaleGpuWindow.add(totalMs);
+    });
+    m_motionToPhoton = new MotionToPhotonMeter(this);
+
+    // refills are deferred so the extra output reconfigurations don't land on top of the one the user asked for
+    m_virtualDisplayPoolTimer = new QTimer(this);
+    m_virtualDisplayPoolTimer->setSingleShot(true);
+    m_virtualDisplayPoolTimer->setInterval(2000);
+    connect(m_virtualDisplayPoolTimer, &QTimer::timeout, this, &BreezyDesktopEffect::refillVirtualDisplayPool);
+    recordStartupPhase(QStringLiteral("watchers"), phaseStart);
 
     // Register DBus object under KWin's session bus name
     auto *adaptor = new BreezyDesktopDBusAdaptor(this);
     const bool dbusOk = QDBusConnection::sessionBus().registerObject(
         QStringLiteral("/com/xronlinux/BreezyDesktop"),
         adaptor,
-        QDBusConnection::ExportAllSlots);
+        QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals);
     if (!dbusOk) {
         qCWarning(KWIN_XR) << "Failed to register DBus object /com/xronlinux/BreezyDesktop";
     }
+    recordStartupPhase(QStringLiteral("constructor"), 0);
 }
 
 BreezyDesktopEffect::~BreezyDesktopEffect()
 {
     qCCritical(KWIN_XR) << "\t\t\tBreezy - destructor";
     if (m_shmFileWatcher) {
-        if (!DataView::SHM_PATH.isEmpty()) {
-            m_shmFileWatcher->removePath(DataView::SHM_PATH);
+        if (!BreezyPose::SHM_PATH.isEmpty()) {
+            m_shmFileWatcher->removePath(BreezyPose::SHM_PATH);
         }
         m_shmFileWatcher->deleteLater();
         m_shmFileWatcher = nullptr;
@@ -236,6 +300,85 @@ BreezyDesktopEffect::~BreezyDesktopEffect()
     deactivate();
 }
 
+void BreezyDesktopEffect::recordStartupPhase(const QString &name, qint64 startNs)
+{
+    m_startupPhases.append({name, startNs, m_startupClock.nsecsElapsed() - startNs});
+}
+
+void BreezyDesktopEffect::requestDriverFeatures()
+{
+    if (m_driverFeaturesRequested) return;
+    m_driverFeaturesRequested = true;
+
+    // safe to request on each load, acts as a no-op if already present
+    const qint64 phaseStart = m_startupClock.nsecsElapsed();
+    QJsonObject flags;
+    QJsonArray requested;
+    requested.append(QStringLiteral("productivity"));
+    requested.append(QStringLiteral("productivity_pro"));
+    flags.insert(QStringLiteral("request_features"), requested);
+    XRDriverIPC::instance().writeControlFlags(flags);
+    recordStartupPhase(QStringLiteral("driverFeatures"), phaseStart);
+}
+
+// the scene compiled into the plugin; its files resolve the BreezyDesktopEffect type through their own module
+static QUrl sceneSourceUrl()
+{
+    return QUrl(QStringLiteral("qrc:/org/kde/kwin/effect/breezy_desktop/scene/main.qml"));
+}
+
+// the same directory the KCM and the driver IPC keep their state and logs in
+static QString stateDirPath()
+{
+    const QString fallback = QDir::homePath() + QStringLiteral("/.local/state");
+    const QString base = qEnvironmentVariable("XDG_STATE_HOME", fallback);
+    return QDir::cleanPath(base + QStringLiteral("/breezy_kwin"));
+}
+
+// presentation feedback comes from the output's render loop; since the logical/backend output split the loop
+// belongs to the backend output behind the logical one the effect sees
+static RenderLoop *renderLoopForScreen(ScreenOutput *screen)
+{
+    if (!screen) return nullptr;
+#if defined(KWIN_VERSION_ENCODED) && KWIN_VERSION_ENCODED >= 60590
+    BackendOutput *backendOutput = screen->backendOutput();
+    return backendOutput ? backendOutput->renderLoop() : nullptr;
+#else
+    return screen->renderLoop();
+#endif
+}
+
+void BreezyDesktopEffect::ensureInitialized()
+{
+    if (m_initialized) return;
+    m_initialized = true;
+
+    const qint64 initStart = m_startupClock.nsecsElapsed();
+    requestDriverFeatures();
+
+    const qint64 phaseStart = m_startupClock.nsecsElapsed();
+    setSource(sceneSourceUrl());
+    recordStartupPhase(QStringLiteral("qmlSource"), phaseStart);
+    recordStartupPhase(QStringLiteral("deferredInit"), initStart);
+}
+
+QVariantMap BreezyDesktopEffect::startupProfile() const
+{
+    QVariantList phases;
+    for (const auto &phase : m_startupPhases) {
+        phases.append(QVariantMap{
+            {QStringLiteral("name"), phase.name},
+            {QStringLiteral("startMs"), phase.startNs / 1.0e6},
+            {QStringLiteral("durationMs"), phase.durationNs / 1.0e6}
+        });
+    }
+
+    return QVariantMap{
+        {QStringLiteral("initialized"), m_initialized},
+        {QStringLiteral("phases"), phases}
+    };
+}
+
 void BreezyDesktopEffect::setupGlobalShortcut(const BreezyShortcuts::Shortcut &shortcut, std::function<void()> triggeredFunc) {
     QAction *action = new QAction(this);
     action->setObjectName(shortcut.actionName);
@@ -257,9 +400,35 @@ void BreezyDesktopEffect::setLookingAtScreenIndex(int index)
     if (m_smoothFollowEnabled) updateDriverSmoothFollowSettings();
 }
 
+void BreezyDesktopEffect::setLookingAtScreenName(const QString &name)
+{
+    if (m_lookingAtScreenName == name) return;
+
+    // both displays change quality, so both need a fresh capture
+    if (!m_lookingAtScreenName.isEmpty()) m_damagedScreens.insert(m_lookingAtScreenName);
+    if (!name.isEmpty()) m_damagedScreens.insert(name);
+
+    m_lookingAtScreenName = name;
+    Q_EMIT lookingAtScreenNameChanged();
+}
+
 void BreezyDesktopEffect::reconfigure(ReconfigureFlags)
 {
+    // our own queued writes have to land first, or re-reading the file would revert them
+    if (m_configWriter) m_configWriter->flush();
     BreezyDesktopConfig::self()->read();
+
+    // the KCM asks for a reconfigure after every save, usually with only one value changed or none at all
+    QVariantMap configSnapshot;
+    const auto items = BreezyDesktopConfig::self()->items();
+    for (const KConfigSkeletonItem *item : items) {
+        configSnapshot.insert(item->name(), item->property());
+    }
+    if (!m_configSnapshot.isEmpty() && configSnapshot == m_configSnapshot) {
+        return;
+    }
+    m_configSnapshot = configSnapshot;
+
     setLookAheadOverride(BreezyDesktopConfig::lookAheadOverride());
     setFocusedDisplayDistance(BreezyDesktopConfig::focusedDisplayDistance() / 100.0f);
     setAllDisplaysDistance(BreezyDesktopConfig::allDisplaysDistance() / 100.0f);
@@ -277,13 +446,39 @@ void BreezyDesktopEffect::reconfigure(ReconfigureFlags)
 
     int wrap = BreezyDesktopConfig::displayWrappingScheme();
     int aaQuality = BreezyDesktopConfig::antialiasingQuality();
+    int textureFiltering = BreezyDesktopConfig::textureFiltering();
     bool removeVD = BreezyDesktopConfig::removeVirtualDisplaysOnDisable();
     bool mirrorPhysicalDisplays = BreezyDesktopConfig::mirrorPhysicalDisplays();
     if (m_displayWrappingScheme != wrap) { m_displayWrappingScheme = wrap; Q_EMIT displayWrappingSchemeChanged(); }
     if (m_antialiasingQuality != aaQuality) { m_antialiasingQuality = aaQuality; Q_EMIT antialiasingQualityChanged(); }
+    if (m_textureFiltering != textureFiltering) { m_textureFiltering = textureFiltering; Q_EMIT textureFilteringChanged(); }
+
+    const qreal renderScaleMin = BreezyDesktopConfig::renderScaleMin() / 100.0;
+    const qreal renderScaleMax = std::max(renderScaleMin, BreezyDesktopConfig::renderScaleMax() / 100.0);
+    m_dynamicRenderScale = BreezyDesktopConfig::dynamicRenderScale();
+    m_renderScaleMin = renderScaleMin;
+    m_renderScaleMax = renderScaleMax;
+    const qreal renderScale = m_dynamicRenderScale ? std::clamp(m_renderScale, renderScaleMin, renderScaleMax) : 1.0;
+    if (!qFuzzyCompare(m_renderScale, renderScale)) { m_renderScale = renderScale; Q_EMIT renderScaleChanged(); }
+
+    const qreal peripheralTextureScale = BreezyDesktopConfig::peripheralTextureScale() / 100.0;
+    const int peripheralRefreshDivisor = BreezyDesktopConfig::peripheralRefreshDivisor();
+    if (!qFuzzyCompare(m_peripheralTextureScale, peripheralTextureScale) || m_peripheralRefreshDivisor != peripheralRefreshDivisor) {
+        m_peripheralTextureScale = peripheralTextureScale;
+        m_peripheralRefreshDivisor = peripheralRefreshDivisor;
+        Q_EMIT peripheralQualityChanged();
+    }
     if (m_removeVirtualDisplaysOnDisable != removeVD) { m_removeVirtualDisplaysOnDisable = removeVD; Q_EMIT removeVirtualDisplaysOnDisableChanged(); }
     if (m_mirrorPhysicalDisplays != mirrorPhysicalDisplays) { m_mirrorPhysicalDisplays = mirrorPhysicalDisplays; Q_EMIT mirrorPhysicalDisplaysChanged(); }
 
+    m_activeVirtualDisplayLayout = BreezyDesktopConfig::virtualDisplayLayout();
+
+    const int virtualDisplayPoolCount = BreezyDesktopConfig::virtualDisplayPoolCount();
+    if (m_virtualDisplayPoolCount != virtualDisplayPoolCount) {
+        m_virtualDisplayPoolCount = virtualDisplayPoolCount;
+        if (isRunning()) scheduleVirtualDisplayPoolRefill();
+    }
+
     const bool developerMode = BreezyDesktopConfig::developerMode();
     if (m_developerMode != developerMode) { m_developerMode = developerMode; Q_EMIT developerModeChanged(); }
 
@@ -307,6 +502,162 @@ QVariantMap BreezyDesktopEffect::initialProperties(ScreenOutput *screen)
     };
 }
 
+void BreezyDesktopEffect::prePaintScreen(ScreenPrePaintData &data, std::chrono::milliseconds presentTime)
+{
+    if (isRunning() && isEffectTargetScreen(data.screen)) {
+        flushDisplayTextureDamage();
+        m_effectFrameTiming = true;
+        m_effectFrameTimer.start();
+
+        // presentation times more than half a refresh later than expected mean at least one vblank was missed; the
+        // first frame after activation or a pause in scheduling has nothing to be measured against
+        if (m_lastEffectPresentTime.count() > 0) {
+            const auto interval = presentTime - m_lastEffectPresentTime;
+            m_presentIntervalMs.add(interval.count());
+            m_lastEffectFrameMissed = interval.count() > targetFrameBudgetMs() * 1.5;
+            if (m_lastEffectFrameMissed) ++m_missedFrames;
+        } else {
+            m_lastEffectFrameMissed = false;
+        }
+        m_lastEffectPresentTime = presentTime;
+
+        // presentTime is on the monotonic clock, pose timestamps are wall clock; carry the lead time across
+        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch());
+        const qint64 presentLeadMs = std::max<qint64>(0, (presentTime - now).count());
+        m_predictedPresentLeadMs.add(presentLeadMs);
+        m_predictedPresentTimestamp = QDateTime::currentMSecsSinceEpoch() + presentLeadMs;
+
+        // per-frame work is paced by the compositor's frames rather than by independent timers
+        updateCursorPos();
+        Q_EMIT framePrepared();
+        logFramePacing();
+
+        // the render scale governor needs the GPU side of the frame cost as much as developer mode's statistics do
+        if (m_developerMode || m_dynamicRenderScale) {
+            if (QuickSceneView *view = viewForScreen(data.screen)) m_gpuPassTimer->attach(view->window());
+        } else {
+            m_gpuPassTimer->detach();
+        }
+
+        // isEffectTargetScreen() passes every screen until QML reports the target, and stamping all of their frames
+        // against the one feedback stream would pair them up wrongly
+        if (m_developerMode && m_effectTargetScreenIndex != -1) {
+            // the camera was just placed for this frame; the look-ahead mirrors lookAheadMS() in CameraController.qml,
+            // which predicts the pose forward to the presentation time plus a constant
+            const qreal lookAheadConstant = m_lookAheadOverride == -1 ? m_lookAheadConfig.value(0) : m_lookAheadOverride;
+            m_motionToPhoton->attach(renderLoopForScreen(data.screen));
+            m_motionToPhoton->stampFrame(presentTime, m_poseTimestamp, m_predictedPresentTimestamp + lookAheadConstant);
+        } else {
+            m_motionToPhoton->detach();
+        }
+    }
+
+    QuickSceneEffect::prePaintScreen(data, presentTime);
+}
+
+void BreezyDesktopEffect::postPaintScreen()
+{
+    QuickSceneEffect::postPaintScreen();
+
+    // CPU-side cost of the effect frame (scene render submission plus compositing), bucketed by
+    // antialiasing mode so the modes can be compared on the same hardware
+    if (m_effectFrameTiming) {
+        m_effectFrameTiming = false;
+        const double frameCostMs = m_effectFrameTimer.nsecsElapsed() / 1e6;
+        m_effectFrameTimeByAntialiasingMode[m_antialiasingQuality].add(frameCostMs);
+        if (m_dynamicRenderScale) updateRenderScale(frameCostMs);
+        scheduleEffectFrame();
+    }
+}
+
+// The head pose changes continuously, so keep requesting frames on the target screen while the 3D view is up.
+void BreezyDesktopEffect::scheduleEffectFrame()
+{
+    if (!isRunning() || !m_enabled || m_poseResetState) {
+        // the gap until frames are requested again isn't a missed deadline
+        m_lastEffectPresentTime = {};
+        return;
+    }
+
+    const auto screensList = effects->screens();
+    if (m_effectTargetScreenIndex != -1 && m_effectTargetScreenIndex < screensList.count()) {
+        effects->addRepaint(screensList.at(m_effectTargetScreenIndex)->geometry());
+    }
+}
+
+void BreezyDesktopEffect::logFramePacing()
+{
+    static constexpr quint64 logIntervalFrames = 600;
+    if (m_framesRendered - m_framesAtLastPacingLog < logIntervalFrames) return;
+
+    const quint64 missed = m_missedFrames - m_missedFramesLogged;
+    if (missed > 0) {
+        qCInfo(KWIN_XR) << "Breezy - missed" << missed << "of the last" << (m_framesRendered - m_framesAtLastPacingLog)
+                        << "presentation deadlines; refresh interval" << targetFrameBudgetMs() << "ms, present interval p50"
+                        << m_presentIntervalMs.percentile(0.5) << "ms p99" << m_presentIntervalMs.percentile(0.99) << "ms";
+    }
+    m_missedFramesLogged = m_missedFrames;
+    m_framesAtLastPacingLog = m_framesRendered;
+}
+
+qreal BreezyDesktopEffect::targetFrameBudgetMs() const
+{
+    const auto screensList = effects->screens();
+    if (m_effectTargetScreenIndex >= 0 && m_effectTargetScreenIndex < screensList.count()) {
+        const ScreenOutput *screen = screensList.at(m_effectTargetScreenIndex);
+
+        // refresh rate is reported in mHz
+        if (screen && screen->refreshRate() > 0) return 1000000.0 / screen->refreshRate();
+    }
+
+    return 1000.0 / 60.0;
+}
+
+// Missed presentation deadlines are the main signal: they're what the scale exists to prevent, and they're the only
+// one that sees a GPU-bound frame, since the CPU-side cost ends once the frame's GL commands are queued. The GPU pass
+// times, where timer queries are supported, are the headroom check before the scale is raised again.
+void BreezyDesktopEffect::updateRenderScale(double frameCostMs)
+{
+    m_renderScaleWindow.add(frameCostMs);
+    if (m_lastEffectFrameMissed) ++m_renderScaleWindowMisses;
+
+    // decide once per full window so a single slow frame doesn't cause the render targets to be reallocated
+    if (m_renderScaleWindow.count() < 60) return;
+
+    const double budgetMs = targetFrameBudgetMs();
+    const double cpuP90 = m_renderScaleWindow.percentile(0.9);
+    const bool gpuTimed = !m_renderScaleGpuWindow.isEmpty();
+    const double gpuP90 = m_renderScaleGpuWindow.percentile(0.9);
+    qreal scale = m_renderScale;
+    if (m_renderScaleWindowMisses > 1 || gpuP90 > budgetMs * 0.85) {
+        scale -= 0.1;
+        m_renderScaleCleanWindows = 0;
+    } else if (m_renderScaleWindowMisses == 0) {
+        // without GPU timings a raised scale is only judged by whether it misses, so give it longer before trying
+        const int cleanWindowsNeeded = gpuTimed ? 1 : 5;
+        if (++m_renderScaleCleanWindows >= cleanWindowsNeeded && cpuP90 < budgetMs * 0.6 && gpuP90 < budgetMs * 0.6) {
+            scale += 0.05;
+            m_renderScaleCleanWindows = 0;
+        }
+    } else {
+        m_renderScaleCleanWindows = 0;
+    }
+    scale = std::clamp(scale, m_renderScaleMin, m_renderScaleMax);
+
+    const int misses = m_renderScaleWindowMisses;
+    m_renderScaleWindow.clear();
+    m_renderScaleGpuWindow.clear();
+    m_renderScaleWindowMisses = 0;
+
+    if (!qFuzzyCompare(m_renderScale, scale)) {
+        qCDebug(KWIN_XR) << "Breezy - render scale" << m_renderScale << "->" << scale << "missed" << misses << "of 60 deadlines,"
+                         << "p90 GPU" << (gpuTimed ? gpuP90 : -1.0) << "ms, p90 CPU" << cpuP90 << "ms, budget" << budgetMs << "ms";
+        m_renderScale = scale;
+        ++m_renderScaleChanges;
+        Q_EMIT renderScaleChanged();
+    }
+}
+
 int BreezyDesktopEffect::requestedEffectChainPosition() const
 {
     return 70;
@@ -330,12 +681,23 @@ void BreezyDesktopEffect::activate()
     }
     qCCritical(KWIN_XR) << "\t\t\tBreezy - activate";
 
+    ensureInitialized();
+    // released again on deactivate()
+    if (source().isEmpty()) setSource(sceneSourceUrl());
     if (!isRunning()) setRunning(true);
 
-    connect(effects, &EffectsHandler::cursorShapeChanged, this, &BreezyDesktopEffect::updateCursorImage);
+    connect(effects, &EffectsHandler::cursorShapeChanged, this, &BreezyDesktopEffect::updateCursorImage, Qt::UniqueConnection);
+    updateCursorImage();
+    // while the effect is active the cursor position is refreshed once per effect frame in prePaintScreen
     if (m_cursorUpdateTimer) {
-        m_cursorUpdateTimer->start();
+        m_cursorUpdateTimer->stop();
+    }
+
+    connectDamageTracking();
+    if (!m_activeVirtualDisplayLayout.isEmpty()) {
+        restoreVirtualDisplayLayout(m_activeVirtualDisplayLayout);
     }
+    scheduleVirtualDisplayPoolRefill();
 
     // QuickSceneEffect grabs the keyboard and mouse input, which pulls focus away from the active window
     // and doesn't allow for interaction with anything on the desktop. These two calls fix that.
@@ -354,6 +716,7 @@ void BreezyDesktopEffect::deactivate()
     qCCritical(KWIN_XR) << "\t\t\tBreezy - deactivate";
 
     m_effectTargetScreenIndex = -1;
+    m_lastEffectPresentTime = {};
     invalidateEffectOnScreenGeometryCache();
 
     disconnect(effects, &EffectsHandler::cursorShapeChanged, this, &BreezyDesktopEffect::updateCursorImage);
@@ -361,6 +724,8 @@ void BreezyDesktopEffect::deactivate()
         m_cursorUpdateTimer->stop();
     }
     showCursor();
+    disconnectDamageTracking();
+    clearVirtualDisplayPool();
 
     if (m_removeVirtualDisplaysOnDisable) {
         for (auto it = m_virtualDisplays.begin(); it != m_virtualDisplays.end(); ++it) {
@@ -368,15 +733,26 @@ void BreezyDesktopEffect::deactivate()
                 KWin::kwinApp()->outputBackend()->removeVirtualOutput(it->output);
             }
         }
-        m_virtualDisplays.clear();
+        if (!m_virtualDisplays.isEmpty()) {
+            m_virtualDisplays.clear();
+            Q_EMIT virtualDisplaysChanged();
+        }
     }
 
     setRunning(false);
+
+    // setRunning(false) only destroys the scene's views; dropping the source also releases the compiled
+    // component, and trimming lets the engine free the type data nothing references anymore
+    if (!source().isEmpty()) {
+        setSource(QUrl());
+        effects->qmlEngine()->trimComponentCache();
+    }
 }
 
 void BreezyDesktopEffect::enableDriver()
 {
     qCCritical(KWIN_XR) << "\t\t\tBreezy - enableDriver";
+    requestDriverFeatures();
     QJsonObject newConfig = QJsonObject();
     auto configJsonOpt = XRDriverIPC::instance().retrieveConfig();
     if (configJsonOpt) {
@@ -400,41 +776,296 @@ void BreezyDesktopEffect::disableDriver()
     XRDriverIPC::instance().writeConfig(newConfig);
 }
 
-void BreezyDesktopEffect::addVirtualDisplay(QSize size)
+QString BreezyDesktopEffect::nextVirtualDisplayId() const
+{
+    // lowest free slot rather than an ever-increasing counter, so a display recreated in the same position
+    // gets the same output name and KWin reuses its stored output configuration (position, scale)
+    for (int slot = 1;; ++slot) {
+        const QString id = QStringLiteral("BreezyDesktop_%1").arg(slot);
+        const bool inPool = std::any_of(m_virtualDisplayPool.cbegin(), m_virtualDisplayPool.cend(), [&id](const VirtualOutputInfo &info) {
+            return info.id == id;
+        });
+        if (!m_virtualDisplays.contains(id) && !inPool) {
+            return id;
+        }
+    }
+}
+
+VirtualOutputHandle *BreezyDesktopEffect::createVirtualOutput(const QString &id, QSize size, qreal scale)
 {
-    static int virtualDisplayCount = 0;
-    ++virtualDisplayCount;
-    QString name = QStringLiteral("BreezyDesktop_%1").arg(virtualDisplayCount);
     #if defined(KWIN_VERSION_ENCODED) && KWIN_VERSION_ENCODED >= 60290
-        QString description = QStringLiteral("Breezy Display %1x%2 (%3)").arg(size.width()).arg(size.height()).arg(virtualDisplayCount);
-        auto output = KWin::kwinApp()->outputBackend()->createVirtualOutput(name, description, size, 1.0);
+        QString description = QStringLiteral("Breezy Display %1x%2 (%3)").arg(size.width()).arg(size.height()).arg(id.section(QLatin1Char('_'), -1));
+        return KWin::kwinApp()->outputBackend()->createVirtualOutput(id, description, size, scale);
     #else
-        auto output = KWin::kwinApp()->outputBackend()->createVirtualOutput(name, size, 1.0);
+        return KWin::kwinApp()->outputBackend()->createVirtualOutput(id, size, scale);
     #endif
-    if (output) {
+}
+
+void BreezyDesktopEffect::setVirtualOutputsEnabled(const QList<VirtualOutputHandle *> &outputs, bool enabled)
+{
+    if (outputs.isEmpty()) return;
+
+    // one configuration for all of them, so KWin only re-lays out the outputs once
+    OutputConfiguration config;
+    for (VirtualOutputHandle *output : outputs) {
+        config.changeSet(output)->enabled = enabled;
+    }
+    workspace()->applyOutputConfiguration(config);
+}
+
+void BreezyDesktopEffect::addVirtualDisplay(QSize size, qreal scale)
+{
+    addVirtualDisplays({{QString(), size.width(), size.height(), scale}});
+}
+
+void BreezyDesktopEffect::addVirtualDisplays(const BreezyVirtualDisplays::VirtualDisplayInfoList &displays)
+{
+    bool added = false;
+    QList<VirtualOutputHandle *> pooledOutputs;
+    for (const auto &display : displays) {
+        const QSize size(display.width, display.height);
+        const qreal scale = display.scale > 0.0 ? display.scale : 1.0;
+        if (size.isEmpty() || scale > 3.0) {
+            qCWarning(KWIN_XR) << "Breezy - ignoring invalid virtual display" << size << display.scale;
+            continue;
+        }
+        m_virtualDisplayPoolResolution = size;
+
+        // pooled outputs are created at scale 1.0, which a disabled output can't be re-scaled from in the same step
+        auto pooled = std::find_if(m_virtualDisplayPool.begin(), m_virtualDisplayPool.end(), [&size, scale](const VirtualOutputInfo &info) {
+            return info.size == size && qFuzzyCompare(info.scale, scale);
+        });
+        if (pooled != m_virtualDisplayPool.end()) {
+            VirtualOutputInfo info = *pooled;
+            m_virtualDisplayPool.erase(pooled);
+            info.order = ++m_virtualDisplaySequence;
+            pooledOutputs << info.output;
+            m_virtualDisplays.insert(info.id, info);
+            added = true;
+            continue;
+        }
+
+        // inserted right away so the next iteration's nextVirtualDisplayId() sees this one as taken
         VirtualOutputInfo info;
-        info.output = output;
-        info.id = name;
+        info.id = nextVirtualDisplayId();
         info.size = size;
-        m_virtualDisplays.insert(info.id, info);
+        info.scale = scale;
+        info.output = createVirtualOutput(info.id, size, info.scale);
+        if (info.output) {
+            info.order = ++m_virtualDisplaySequence;
+            m_virtualDisplays.insert(info.id, info);
+            added = true;
+        } else {
+            qCWarning(KWIN_XR) << "Breezy - failed to create virtual display" << size;
+        }
+    }
+    setVirtualOutputsEnabled(pooledOutputs, true);
+
+    if (added) {
+        Q_EMIT virtualDisplaysChanged();
+        scheduleVirtualDisplayPoolRefill();
+    }
+}
+
+void BreezyDesktopEffect::scheduleVirtualDisplayPoolRefill()
+{
+    if (m_virtualDisplayPoolTimer) {
+        m_virtualDisplayPoolTimer->start();
+    }
+}
+
+void BreezyDesktopEffect::refillVirtualDisplayPool()
+{
+    if (!isRunning()) return;
+
+    // pooled outputs of a size that's no longer being requested are replaced
+    QList<VirtualOutputHandle *> stale;
+    for (auto it = m_virtualDisplayPool.begin(); it != m_virtualDisplayPool.end();) {
+        if (it->size != m_virtualDisplayPoolResolution || m_virtualDisplayPool.size() > m_virtualDisplayPoolCount) {
+            stale << it->output;
+            it = m_virtualDisplayPool.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (VirtualOutputHandle *output : std::as_const(stale)) {
+        KWin::kwinApp()->outputBackend()->removeVirtualOutput(output);
     }
+
+    QList<VirtualOutputHandle *> created;
+    while (m_virtualDisplayPool.size() < m_virtualDisplayPoolCount) {
+        VirtualOutputInfo info;
+        info.id = nextVirtualDisplayId();
+        info.size = m_virtualDisplayPoolResolution;
+        info.output = createVirtualOutput(info.id, info.size, info.scale);
+        if (!info.output) {
+            qCWarning(KWIN_XR) << "Breezy - failed to create pooled virtual display" << info.size;
+            break;
+        }
+        created << info.output;
+        m_virtualDisplayPool << info;
+    }
+    setVirtualOutputsEnabled(created, false);
 }
 
-QVariantList BreezyDesktopEffect::listVirtualDisplays() const {
-    QVariantList list;
+void BreezyDesktopEffect::clearVirtualDisplayPool()
+{
+    if (m_virtualDisplayPoolTimer) {
+        m_virtualDisplayPoolTimer->stop();
+    }
+    for (const auto &info : std::as_const(m_virtualDisplayPool)) {
+        KWin::kwinApp()->outputBackend()->removeVirtualOutput(info.output);
+    }
+    m_virtualDisplayPool.clear();
+}
+
+QList<BreezyDesktopEffect::VirtualOutputInfo> BreezyDesktopEffect::orderedVirtualDisplays() const
+{
+    QList<VirtualOutputInfo> displays;
     for (auto it = m_virtualDisplays.constBegin(); it != m_virtualDisplays.constEnd(); ++it) {
-        const auto &info = it.value();
-        if (!info.output)
-            continue;
-        QVariantMap entry;
-        entry.insert(QStringLiteral("id"), info.id);
-        entry.insert(QStringLiteral("width"), info.size.width());
-        entry.insert(QStringLiteral("height"), info.size.height());
-        list.push_back(entry);
+        if (it->output) displays << it.value();
+    }
+    std::sort(displays.begin(), displays.end(), [](const VirtualOutputInfo &a, const VirtualOutputInfo &b) {
+        return a.order < b.order;
+    });
+    return displays;
+}
+
+BreezyVirtualDisplays::VirtualDisplayInfoList BreezyDesktopEffect::listVirtualDisplays() const {
+    BreezyVirtualDisplays::VirtualDisplayInfoList list;
+    for (const auto &info : orderedVirtualDisplays()) {
+        list.push_back({info.id, info.size.width(), info.size.height(), info.output->scale()});
     }
     return list;
 }
 
+static QJsonObject readVirtualDisplayLayouts()
+{
+    const QJsonDocument doc = QJsonDocument::fromJson(BreezyDesktopConfig::virtualDisplayLayouts().toUtf8());
+    return doc.isObject() ? doc.object() : QJsonObject();
+}
+
+static void writeVirtualDisplayLayouts(const QJsonObject &layouts)
+{
+    BreezyDesktopConfig::setVirtualDisplayLayouts(QString::fromUtf8(QJsonDocument(layouts).toJson(QJsonDocument::Compact)));
+}
+
+QStringList BreezyDesktopEffect::virtualDisplayLayoutNames() const
+{
+    return readVirtualDisplayLayouts().keys();
+}
+
+QString BreezyDesktopEffect::activeVirtualDisplayLayout() const
+{
+    return m_activeVirtualDisplayLayout;
+}
+
+bool BreezyDesktopEffect::saveVirtualDisplayLayout(const QString &name)
+{
+    if (name.isEmpty()) return false;
+
+    QJsonArray displays;
+    for (const auto &info : orderedVirtualDisplays()) {
+        // the output's current scale, so changes made in the display settings are kept
+        displays.append(QJsonObject{
+            {QStringLiteral("id"), info.id},
+            {QStringLiteral("width"), info.size.width()},
+            {QStringLiteral("height"), info.size.height()},
+            {QStringLiteral("scale"), info.output->scale()}
+        });
+    }
+
+    QJsonObject layouts = readVirtualDisplayLayouts();
+    layouts.insert(name, displays);
+    writeVirtualDisplayLayouts(layouts);
+    BreezyDesktopConfig::setVirtualDisplayLayout(name);
+    m_configWriter->queue(QStringLiteral("VirtualDisplayLayouts"));
+    m_configWriter->queue(QStringLiteral("VirtualDisplayLayout"));
+    m_activeVirtualDisplayLayout = name;
+    return true;
+}
+
+bool BreezyDesktopEffect::removeVirtualDisplayLayout(const QString &name)
+{
+    QJsonObject layouts = readVirtualDisplayLayouts();
+    if (!layouts.contains(name)) return false;
+
+    layouts.remove(name);
+    writeVirtualDisplayLayouts(layouts);
+    if (m_activeVirtualDisplayLayout == name) {
+        BreezyDesktopConfig::setVirtualDisplayLayout(QString());
+        m_configWriter->queue(QStringLiteral("VirtualDisplayLayout"));
+        m_activeVirtualDisplayLayout.clear();
+    }
+    m_configWriter->queue(QStringLiteral("VirtualDisplayLayouts"));
+    return true;
+}
+
+bool BreezyDesktopEffect::restoreVirtualDisplayLayout(const QString &name)
+{
+    const QJsonObject layouts = readVirtualDisplayLayouts();
+    if (!layouts.contains(name)) {
+        qCWarning(KWIN_XR) << "Breezy - no virtual display layout named" << name;
+        return false;
+    }
+
+    // pooled outputs may hold the ids the layout asks for
+    clearVirtualDisplayPool();
+
+    bool changed = false;
+    const QJsonArray displays = layouts.value(name).toArray();
+    QSet<QString> layoutIds;
+    for (const QJsonValue &value : displays) {
+        const QJsonObject entry = value.toObject();
+        VirtualOutputInfo info;
+        info.id = entry.value(QStringLiteral("id")).toString();
+        info.size = QSize(entry.value(QStringLiteral("width")).toInt(), entry.value(QStringLiteral("height")).toInt());
+        info.scale = entry.value(QStringLiteral("scale")).toDouble(1.0);
+        if (info.id.isEmpty() || info.size.isEmpty() || layoutIds.contains(info.id)) {
+            qCWarning(KWIN_XR) << "Breezy - skipping invalid entry in virtual display layout" << name << entry;
+            continue;
+        }
+        layoutIds.insert(info.id);
+
+        // displays that survived the last disable are kept as long as they still match
+        auto existing = m_virtualDisplays.find(info.id);
+        if (existing != m_virtualDisplays.end()) {
+            if (existing->size == info.size) continue;
+            KWin::kwinApp()->outputBackend()->removeVirtualOutput(existing->output);
+            m_virtualDisplays.erase(existing);
+        }
+
+        info.output = createVirtualOutput(info.id, info.size, info.scale);
+        if (!info.output) {
+            qCWarning(KWIN_XR) << "Breezy - failed to restore virtual display" << info.id << info.size;
+            continue;
+        }
+        info.order = ++m_virtualDisplaySequence;
+        m_virtualDisplays.insert(info.id, info);
+        changed = true;
+    }
+
+    // displays that aren't part of the layout go away
+    for (auto it = m_virtualDisplays.begin(); it != m_virtualDisplays.end();) {
+        if (!layoutIds.contains(it->id)) {
+            if (it->output) KWin::kwinApp()->outputBackend()->removeVirtualOutput(it->output);
+            it = m_virtualDisplays.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_activeVirtualDisplayLayout != name) {
+        m_activeVirtualDisplayLayout = name;
+        BreezyDesktopConfig::setVirtualDisplayLayout(name);
+        m_configWriter->queue(QStringLiteral("VirtualDisplayLayout"));
+    }
+    if (changed) Q_EMIT virtualDisplaysChanged();
+    scheduleVirtualDisplayPoolRefill();
+    return true;
+}
+
 bool BreezyDesktopEffect::removeVirtualDisplay(const QString &id) {
     auto it = m_virtualDisplays.find(id);
     if (it != m_virtualDisplays.end()) {
@@ -443,6 +1074,7 @@ bool BreezyDesktopEffect::removeVirtualDisplay(const QString &id) {
             KWin::kwinApp()->outputBackend()->removeVirtualOutput(output);
         }
         m_virtualDisplays.erase(it);
+        Q_EMIT virtualDisplaysChanged();
         return true;
     }
     return false;
@@ -472,7 +1104,10 @@ void BreezyDesktopEffect::setZoomOnFocusEnabled(bool enabled) {
             BreezyDesktopConfig::setFocusedDisplayDistance(static_cast<int>(m_focusedDisplayDistance * 100.0f));
         }
         BreezyDesktopConfig::setZoomOnFocusEnabled(enabled);
-        BreezyDesktopConfig::self()->save();
+        if (m_configWriter) {
+            m_configWriter->queue(QStringLiteral("FocusedDisplayDistance"));
+            m_configWriter->queue(QStringLiteral("ZoomOnFocusEnabled"));
+        }
         Q_EMIT zoomOnFocusChanged();
     }
 }
@@ -503,6 +1138,10 @@ quint64 BreezyDesktopEffect::poseTimestamp() const {
     return m_poseTimestamp;
 }
 
+qreal BreezyDesktopEffect::predictedPresentTimestamp() const {
+    return m_predictedPresentTimestamp;
+}
+
 bool BreezyDesktopEffect::poseHasPosition() const {
     return m_poseHasPosition;
 }
@@ -531,8 +1170,10 @@ qreal BreezyDesktopEffect::focusedDisplayDistance() const {
 }
 
 void BreezyDesktopEffect::setFocusedDisplayDistance(qreal distance) {
-    if (distance != m_focusedDisplayDistance) {
-        m_focusedDisplayDistance = std::clamp(distance, 0.1, m_allDisplaysDistance);
+    // compared after clamping, so re-applying an out-of-range config value doesn't signal every time
+    const qreal clamped = std::clamp(distance, 0.1, m_allDisplaysDistance);
+    if (clamped != m_focusedDisplayDistance) {
+        m_focusedDisplayDistance = clamped;
         Q_EMIT focusedDisplayDistanceChanged();
 
         if (m_smoothFollowEnabled) updateDriverSmoothFollowSettings();
@@ -544,9 +1185,10 @@ qreal BreezyDesktopEffect::allDisplaysDistance() const {
 }
 
 void BreezyDesktopEffect::setAllDisplaysDistance(qreal distance) {
-    if (distance != m_allDisplaysDistance) {
-        qreal min = m_zoomOnFocusEnabled ? m_focusedDisplayDistance : 0.1;
-        m_allDisplaysDistance = std::clamp(distance, min, 2.5);
+    const qreal min = m_zoomOnFocusEnabled ? m_focusedDisplayDistance : 0.1;
+    const qreal clamped = std::clamp(distance, min, 2.5);
+    if (clamped != m_allDisplaysDistance) {
+        m_allDisplaysDistance = clamped;
         Q_EMIT allDisplaysDistanceChanged();
     }
 }
@@ -606,6 +1248,18 @@ int BreezyDesktopEffect::antialiasingQuality() const {
     return m_antialiasingQuality;
 }
 
+int BreezyDesktopEffect::textureFiltering() const {
+    return m_textureFiltering;
+}
+
+qreal BreezyDesktopEffect::renderScale() const {
+    return m_renderScale;
+}
+
+qreal BreezyDesktopEffect::peripheralTextureScale() const {
+    return m_peripheralTextureScale;
+}
+
 bool BreezyDesktopEffect::removeVirtualDisplaysOnDisable() const {
     return m_removeVirtualDisplaysOnDisable;
 }
@@ -644,23 +1298,6 @@ bool BreezyDesktopEffect::smoothFollowEnabled() const {
     return m_focusedSmoothFollowEnabled;
 }
 
-bool BreezyDesktopEffect::checkParityByte(const char* data) {
-    const uint8_t parityByte = static_cast<uint8_t>(data[DataView::POSE_PARITY_BYTE[DataView::OFFSET_INDEX]]);
-    uint8_t parity = 0;
-
-    const int dateBytes = DataView::POSE_DATE_MS[DataView::COUNT_INDEX] * DataView::POSE_DATE_MS[DataView::SIZE_INDEX];
-    for (int i = 0; i < dateBytes; ++i) {
-        parity ^= static_cast<uint8_t>(data[DataView::POSE_DATE_MS[DataView::OFFSET_INDEX] + i]);
-    }
-
-    const int quatBytes = DataView::POSE_ORIENTATION_DATA[DataView::COUNT_INDEX] * DataView::POSE_ORIENTATION_DATA[DataView::SIZE_INDEX];
-    for (int i = 0; i < quatBytes; ++i) {
-        parity ^= static_cast<uint8_t>(data[DataView::POSE_ORIENTATION_DATA[DataView::OFFSET_INDEX] + i]);
-    }
-
-    return parityByte == parity;
-}
-
 static qint64 lastConfigUpdate = 0;
 static qint64 activatedAt = 0;
 void BreezyDesktopEffect::updatePose() {    
@@ -676,72 +1313,43 @@ void BreezyDesktopEffect::updatePose() {
     // destructor called on function exit, triggers reset of the flag
     struct ResetFlag { std::atomic<bool>* f; ~ResetFlag(){ f->store(false); } } reset{&m_poseUpdateInProgress};
 
-    const QString shmPath = QStringLiteral("/dev/shm/breezy_desktop_imu");
-    QFile shmFile(shmPath);
-    if (!shmFile.open(QIODevice::ReadOnly)) {
-        return;
-    }
-    QByteArray buffer = shmFile.readAll();
-    shmFile.close();
-    if (buffer.size() != DataView::LENGTH) return;
+    // torn reads are counted by the reader and dropped; the next write will bring a whole block
+    const qint64 currentTimeMs = QDateTime::currentMSecsSinceEpoch();
+    const auto pose = m_poseReader->read(currentTimeMs);
+    if (!pose) return;
 
-    const char* data = buffer.constData();
-    if (!checkParityByte(data)) return;
+    const uint8_t version = pose->version;
+    const bool enabledFlag = pose->enabled;
+    const uint64_t poseDateMs = pose->poseDateMs;
 
-    uint8_t version = static_cast<uint8_t>(data[DataView::VERSION[DataView::OFFSET_INDEX]]);
-    uint8_t enabledFlag = static_cast<uint8_t>(data[DataView::ENABLED[DataView::OFFSET_INDEX]]);
-    uint64_t poseDateMs;
-    memcpy(&poseDateMs, data + DataView::POSE_DATE_MS[DataView::OFFSET_INDEX], sizeof(poseDateMs));
-    poseDateMs = qFromLittleEndian(poseDateMs);
+    recordPoseIngest(*pose, currentTimeMs);
 
-    const qint64 currentTimeMs = QDateTime::currentMSecsSinceEpoch();
     const bool updateConfig = lastConfigUpdate == 0 || currentTimeMs - lastConfigUpdate > 1000;
 
     if (updateConfig) {
-        float lookAheadConfig[4];
-        memcpy(&lookAheadConfig[0], data + DataView::LOOK_AHEAD_CFG[DataView::OFFSET_INDEX], sizeof(lookAheadConfig));
-        m_lookAheadConfig.clear();
-        m_lookAheadConfig.append(lookAheadConfig[0]);
-        m_lookAheadConfig.append(lookAheadConfig[1]);
-        m_lookAheadConfig.append(lookAheadConfig[2]);
-        m_lookAheadConfig.append(lookAheadConfig[3]);
-
-        uint32_t displayResolution[2];
-        memcpy(&displayResolution[0], data + DataView::DISPLAY_RES[DataView::OFFSET_INDEX], sizeof(displayResolution));
-        m_displayResolution.clear();
-        m_displayResolution.append(displayResolution[0]);
-        m_displayResolution.append(displayResolution[1]);
-
-        float displayFov = 0.0f;
-        memcpy(&displayFov, data + DataView::DISPLAY_FOV[DataView::OFFSET_INDEX], sizeof(displayFov));
-        m_diagonalFOV = displayFov;
-
-        float lensDistanceRatio = 0.0f;
-        memcpy(&lensDistanceRatio, data + DataView::LENS_DISTANCE_RATIO[DataView::OFFSET_INDEX], sizeof(lensDistanceRatio));
-        m_lensDistanceRatio = lensDistanceRatio;
-
-        uint8_t sbsEnabled = false;
-        memcpy(&sbsEnabled, data + DataView::SBS_ENABLED[DataView::OFFSET_INDEX], sizeof(sbsEnabled));
-        m_sbsEnabled = (sbsEnabled != 0);
-
-        uint8_t customBannerEnabled = false;
-        memcpy(&customBannerEnabled, data + DataView::CUSTOM_BANNER_ENABLED[DataView::OFFSET_INDEX], sizeof(customBannerEnabled));
-        m_customBannerEnabled = (customBannerEnabled != 0);
-        
+        m_lookAheadConfig = QList<qreal>(pose->lookAheadConfig.cbegin(), pose->lookAheadConfig.cend());
+        m_displayResolution = {static_cast<quint32>(pose->displayResolution.width()), static_cast<quint32>(pose->displayResolution.height())};
+
+        m_diagonalFOV = pose->diagonalFov;
+        m_lensDistanceRatio = pose->lensDistanceRatio;
+
+        if (m_sbsEnabled != pose->sbsEnabled) {
+            m_sbsEnabled = pose->sbsEnabled;
+            Q_EMIT sbsEnabledChanged();
+        }
+
+        m_customBannerEnabled = pose->customBannerEnabled;
+
         lastConfigUpdate = currentTimeMs;
     }
 
-    const bool validKeepAlive = (currentTimeMs - poseDateMs) < 5000;
-    const bool validData = validKeepAlive && m_diagonalFOV != 0.0f;
-    const uint8_t expectedVersion = 5;
-    bool enabledFlagSet = (enabledFlag != 0);
-    bool validVersion = (version == expectedVersion);
     const bool wasEnabled = m_enabled;
-    const bool enabled = enabledFlagSet && validVersion && validData;
+    const bool enabled = BreezyPose::isActive(pose->status);
     if (!enabled) {
         // give a grace period after enabling the effect
         if (wasEnabled && (currentTimeMs - activatedAt > 1000)) {
             qCCritical(KWIN_XR) << "\t\t\tBreezy - disabling effect; currentTimeMs:" << currentTimeMs
+                                << "status:" << static_cast<int>(pose->status)
                                 << "poseDateMs:" << poseDateMs
                                 << "enabledFlag:" << enabledFlag
                                 << "version:" << version
@@ -774,65 +1382,30 @@ void BreezyDesktopEffect::updatePose() {
     
     if (updateConfig) Q_EMIT devicePropertiesChanged();
 
-    float posePositionData[3];
-    memcpy(posePositionData, data + DataView::POSE_POSITION_DATA[DataView::OFFSET_INDEX], sizeof(posePositionData));
-
-    // convert NWU to EUS by passing position values: -y, z, -x
-    m_posePosition = QVector3D(-posePositionData[1], posePositionData[2], -posePositionData[0]);
-
-    float poseOrientationData[4 * DataView::POSE_ORIENTATION_ENTRIES]; // 4 quaternion-sized rows
-    memcpy(poseOrientationData, data + DataView::POSE_ORIENTATION_DATA[DataView::OFFSET_INDEX], sizeof(poseOrientationData));
     bool wasPoseResetState = m_poseResetState;
-    m_poseResetState = (poseOrientationData[0] == 0.0f && poseOrientationData[1] == 0.0f && poseOrientationData[2] == 0.0f && poseOrientationData[3] == 1.0f);
+    m_poseResetState = pose->poseResetState;
     if (m_poseResetState != wasPoseResetState) {
         if (m_poseResetState) recenter();
         Q_EMIT poseResetStateChanged();
     }
 
-    // convert NWU to EUS by passing orientation values: -y, z, -x
-    QQuaternion quatT0(poseOrientationData[3], -poseOrientationData[1], poseOrientationData[2], -poseOrientationData[0]);
-
-    int orientationDataOffset = DataView::POSE_ORIENTATION_ENTRIES;
-    QQuaternion quatT1(poseOrientationData[orientationDataOffset + 3], -poseOrientationData[orientationDataOffset + 1], poseOrientationData[orientationDataOffset + 2], -poseOrientationData[orientationDataOffset + 0]);
-
-    orientationDataOffset += DataView::POSE_ORIENTATION_ENTRIES;
-
-    // skip the 3rd quaternion
-    orientationDataOffset += DataView::POSE_ORIENTATION_ENTRIES;
-
-    // set poseOrientations to the last two rotations, leave out the elapsed time
-    m_poseOrientations.clear();
-    m_poseOrientations.append(quatT0);
-    m_poseOrientations.append(quatT1);
-
-    // 4th row isn't actually a quaternion, it contains the timestamps for each of the 3 quaternions
-    // elapsed time between T0 and T1 is: poseOrientationData[0] - poseOrientationData[1]
-    m_poseTimeElapsedMs = static_cast<quint32>(poseOrientationData[orientationDataOffset + 0] - poseOrientationData[orientationDataOffset + 1]);
-
-    m_poseTimestamp = poseDateMs;
-    
-    float originData[4 * DataView::POSE_ORIENTATION_ENTRIES]; // 4 quaternion-sized rows
-    memcpy(originData, data + DataView::SMOOTH_FOLLOW_ORIGIN_DATA[DataView::OFFSET_INDEX], sizeof(originData));
-
-    // convert NWU to EUS by passing root.rotation values: -y, z, -x
-    QQuaternion sfQuatT0(originData[3], -originData[1], originData[2], -originData[0]);
+    m_posePosition = pose->position;
 
-    int originDataOffset = DataView::POSE_ORIENTATION_ENTRIES;
-    QQuaternion sfQuatT1(originData[originDataOffset + 3], -originData[originDataOffset + 1], originData[originDataOffset + 2], -originData[originDataOffset + 0]);
+    // the last two rotations, the oldest row isn't used
+    m_poseOrientations = {pose->orientation, pose->previousOrientation};
 
-    originDataOffset += DataView::POSE_ORIENTATION_ENTRIES;
+    // elapsed time between T0 and T1
+    m_poseTimeElapsedMs = static_cast<quint32>(pose->orientationTimestampMs - pose->previousOrientationTimestampMs);
 
-    // skip the 3rd quaternion
-    originDataOffset += DataView::POSE_ORIENTATION_ENTRIES;
+    m_poseTimestamp = pose->poseDateMs;
+    if (currentTimeMs - m_posePublishedAtMs >= POSE_PUBLISH_INTERVAL_MS) {
+        m_posePublishedAtMs = currentTimeMs;
+        Q_EMIT posePublished();
+    }
 
-    // set smoothFollowOrigin to the last two rotations, leave out the elapsed time
-    m_smoothFollowOrigin.clear();
-    m_smoothFollowOrigin.append(sfQuatT0);
-    m_smoothFollowOrigin.append(sfQuatT1);
+    m_smoothFollowOrigin = {pose->smoothFollowOrigin, pose->previousSmoothFollowOrigin};
 
-    uint8_t smoothFollowEnabled = false;
-    memcpy(&smoothFollowEnabled, data + DataView::SMOOTH_FOLLOW_ENABLED[DataView::OFFSET_INDEX], sizeof(smoothFollowEnabled));
-    bool nextSmoothFollowEnabled = (smoothFollowEnabled != 0);
+    bool nextSmoothFollowEnabled = pose->smoothFollowEnabled;
     bool focusedSmoothFollowEnabled = nextSmoothFollowEnabled && !m_allDisplaysFollowMode;
     if (m_smoothFollowEnabled != nextSmoothFollowEnabled || m_focusedSmoothFollowEnabled != focusedSmoothFollowEnabled) {
         m_smoothFollowEnabled = nextSmoothFollowEnabled;
@@ -851,6 +1424,27 @@ void BreezyDesktopEffect::updatePose() {
     }
 }
 
+void BreezyDesktopEffect::recordPoseIngest(const BreezyPose::PoseSnapshot &pose, qint64 currentTimeMs) {
+    // the file watcher and the watchdog both read the file, so the same sample is often seen more than once
+    if (m_poseSamplesIngested > 0 && pose.orientationTimestampMs == m_lastIngestedSampleMs) {
+        ++m_poseReadsUnchanged;
+        return;
+    }
+
+    // the block also carries its predecessor's timestamp, so a gap between that and the last sample we read means
+    // samples were written and overwritten unread; a timestamp going backwards is a driver restart, not a gap
+    if (m_poseSamplesIngested > 0 && pose.orientationTimestampMs > m_lastIngestedSampleMs
+        && pose.previousOrientationTimestampMs != m_lastIngestedSampleMs) {
+        const float interval = pose.orientationTimestampMs - pose.previousOrientationTimestampMs;
+        const float skipped = interval > 0.0f ? std::round((pose.orientationTimestampMs - m_lastIngestedSampleMs) / interval) - 1.0f : 1.0f;
+        m_poseSamplesMissed += static_cast<quint64>(std::max(skipped, 1.0f));
+    }
+
+    ++m_poseSamplesIngested;
+    m_lastIngestedSampleMs = pose.orientationTimestampMs;
+    m_poseIngestLatencyMs.add(static_cast<double>(currentTimeMs - static_cast<qint64>(pose.poseDateMs)));
+}
+
 void BreezyDesktopEffect::setSmoothFollowThreshold(float threshold) {
     if (m_smoothFollowThreshold != threshold) {
         m_smoothFollowThreshold = threshold;
@@ -999,6 +1593,222 @@ bool BreezyDesktopEffect::updateEffectOnScreenGeometryCache()
     return true;
 }
 
+bool BreezyDesktopEffect::isEffectTargetScreen(const ScreenOutput *screen) const
+{
+    // before QML reports the target screen, treat every screen's frame as an effect frame
+    if (m_effectTargetScreenIndex == -1) return true;
+
+    const auto screensList = effects->screens();
+    if (m_effectTargetScreenIndex >= screensList.count()) return false;
+    return screensList.at(m_effectTargetScreenIndex) == screen;
+}
+
+void BreezyDesktopEffect::connectDamageTracking()
+{
+    if (!m_damageConnections.isEmpty()) return;
+
+    m_damageConnections << connect(effects, &EffectsHandler::windowDamaged, this, [this](EffectWindow *window) {
+        if (window) markScreensDamaged(window->frameGeometry());
+    });
+    m_damageConnections << connect(effects, &EffectsHandler::windowAdded, this, [this](EffectWindow *window) {
+        trackWindowDamage(window);
+        markScreensDamaged(window->frameGeometry());
+    });
+    m_damageConnections << connect(effects, &EffectsHandler::windowDeleted, this, [this](EffectWindow *window) {
+        untrackWindowDamage(window);
+        markScreensDamaged(window->frameGeometry());
+    });
+
+    // these change what's visible on every display, not just the area of a single window
+    m_damageConnections << connect(effects, &EffectsHandler::stackingOrderChanged, this, &BreezyDesktopEffect::markAllScreensDamaged);
+    m_damageConnections << connect(effects, &EffectsHandler::desktopChanged, this, &BreezyDesktopEffect::markAllScreensDamaged);
+    m_damageConnections << connect(effects, &EffectsHandler::screenAdded, this, &BreezyDesktopEffect::markAllScreensDamaged);
+    m_damageConnections << connect(effects, &EffectsHandler::screenRemoved, this, &BreezyDesktopEffect::markAllScreensDamaged);
+
+    const auto windows = effects->stackingOrder();
+    for (EffectWindow *window : windows) {
+        trackWindowDamage(window);
+    }
+
+    markAllScreensDamaged();
+}
+
+void BreezyDesktopEffect::disconnectDamageTracking()
+{
+    for (const auto &connection : std::as_const(m_damageConnections)) {
+        disconnect(connection);
+    }
+    m_damageConnections.clear();
+    for (const auto &connections : std::as_const(m_windowDamageConnections)) {
+        for (const auto &connection : connections) {
+            disconnect(connection);
+        }
+    }
+    m_windowDamageConnections.clear();
+    m_damagedScreens.clear();
+}
+
+void BreezyDesktopEffect::trackWindowDamage(EffectWindow *window)
+{
+    if (!window || m_windowDamageConnections.contains(window)) return;
+
+    // moving or (un)minimizing a window doesn't damage its contents, but it does change the display textures
+    QList<QMetaObject::Connection> &connections = m_windowDamageConnections[window];
+    connections << connect(window, &EffectWindow::windowFrameGeometryChanged, this,
+        [this](EffectWindow *w, const QRectF &oldGeometry) {
+            markScreensDamaged(oldGeometry);
+            markScreensDamaged(w->frameGeometry());
+        });
+    connections << connect(window, &EffectWindow::minimizedChanged, this, [this, window]() {
+        markScreensDamaged(window->frameGeometry());
+    });
+}
+
+void BreezyDesktopEffect::untrackWindowDamage(EffectWindow *window)
+{
+    const QList<QMetaObject::Connection> connections = m_windowDamageConnections.take(window);
+    for (const auto &connection : connections) {
+        disconnect(connection);
+    }
+}
+
+void BreezyDesktopEffect::markScreensDamaged(const QRectF &geometry)
+{
+    const auto screensList = effects->screens();
+    bool damaged = false;
+    for (const ScreenOutput *screen : screensList) {
+        if (screen && QRectF(screen->geometry()).intersects(geometry)) {
+            m_damagedScreens.insert(screen->name());
+            damaged = true;
+        }
+    }
+
+    // make sure the effect target screen repaints so the damage gets flushed, even if nothing on it moved
+    if (damaged && m_effectTargetScreenIndex != -1 && m_effectTargetScreenIndex < screensList.count()) {
+        effects->addRepaint(screensList.at(m_effectTargetScreenIndex)->geometry());
+    }
+}
+
+void BreezyDesktopEffect::markAllScreensDamaged()
+{
+    markScreensDamaged(effects->virtualScreenGeometry());
+}
+
+void BreezyDesktopEffect::flushDisplayTextureDamage()
+{
+    ++m_framesRendered;
+    if (m_damagedScreens.isEmpty()) {
+        m_displayTexturesRefreshedPerFrame.add(0);
+        return;
+    }
+
+    // peripheral displays only refresh every m_peripheralRefreshDivisor frames; their damage carries over until then
+    const bool peripheralRefreshFrame = m_peripheralRefreshDivisor <= 1
+        || m_lookingAtScreenName.isEmpty()
+        || m_framesRendered % m_peripheralRefreshDivisor == 0;
+
+    QStringList screenNames;
+    for (auto it = m_damagedScreens.begin(); it != m_damagedScreens.end();) {
+        if (!peripheralRefreshFrame && *it != m_lookingAtScreenName) {
+            ++m_peripheralRefreshesDeferred;
+            ++it;
+            continue;
+        }
+        screenNames.append(*it);
+        it = m_damagedScreens.erase(it);
+    }
+
+    // deferred damage still needs another effect frame to be flushed on
+    if (!m_damagedScreens.isEmpty()) {
+        const auto screensList = effects->screens();
+        if (m_effectTargetScreenIndex != -1 && m_effectTargetScreenIndex < screensList.count()) {
+            effects->addRepaint(screensList.at(m_effectTargetScreenIndex)->geometry());
+        }
+    }
+    if (screenNames.isEmpty()) {
+        m_displayTexturesRefreshedPerFrame.add(0);
+        return;
+    }
+
+    m_displayTexturesRefreshed += screenNames.size();
+    m_displayTexturesRefreshedPerFrame.add(screenNames.size());
+    Q_EMIT displayTexturesDamaged(screenNames);
+}
+
+QVariantMap BreezyDesktopEffect::poseState() const
+{
+    const QQuaternion orientation = m_poseOrientations.isEmpty() ? QQuaternion() : m_poseOrientations.first();
+    const QVector3D euler = orientation.toEulerAngles();
+    return QVariantMap{
+        {QStringLiteral("enabled"), m_enabled},
+        {QStringLiteral("poseTimestamp"), static_cast<qulonglong>(m_poseTimestamp)},
+        {QStringLiteral("poseResetState"), m_poseResetState},
+        {QStringLiteral("poseHasPosition"), m_poseHasPosition},
+        {QStringLiteral("smoothFollowEnabled"), m_smoothFollowEnabled},
+        // EUS, scalar first
+        {QStringLiteral("orientation"), QVariantList{orientation.scalar(), orientation.x(), orientation.y(), orientation.z()}},
+        {QStringLiteral("yawDegrees"), euler.y()},
+        {QStringLiteral("pitchDegrees"), euler.x()},
+        {QStringLiteral("rollDegrees"), euler.z()},
+        {QStringLiteral("position"), QVariantList{m_posePosition.x(), m_posePosition.y(), m_posePosition.z()}}
+    };
+}
+
+QVariantMap BreezyDesktopEffect::motionToPhotonStats() const
+{
+    QVariantMap stats = m_motionToPhoton->summary();
+    stats.insert(QStringLiteral("developerMode"), m_developerMode);
+    return stats;
+}
+
+QString BreezyDesktopEffect::writeMotionToPhotonCsv(const QString &path) const
+{
+    const QString target = path.isEmpty() ? stateDirPath() + QStringLiteral("/motion_to_photon.csv") : path;
+    if (!m_motionToPhoton->writeCsv(target)) {
+        qCWarning(KWIN_XR) << "Breezy - failed to write motion-to-photon samples to" << target;
+        return QString();
+    }
+    return target;
+}
+
+void BreezyDesktopEffect::resetMotionToPhoton()
+{
+    m_motionToPhoton->reset();
+}
+
+QVariantMap BreezyDesktopEffect::renderStats() const
+{
+    QVariantMap frameTimes;
+    for (auto it = m_effectFrameTimeByAntialiasingMode.cbegin(); it != m_effectFrameTimeByAntialiasingMode.cend(); ++it) {
+        frameTimes.insert(QString::number(it.key()), it.value().summary());
+    }
+
+    return QVariantMap{
+        {QStringLiteral("framesRendered"), static_cast<qulonglong>(m_framesRendered)},
+        {QStringLiteral("displayTexturesRefreshed"), static_cast<qulonglong>(m_displayTexturesRefreshed)},
+        {QStringLiteral("displayTexturesRefreshedPerFrame"), m_displayTexturesRefreshedPerFrame.summary()},
+        {QStringLiteral("antialiasingQuality"), m_antialiasingQuality},
+        {QStringLiteral("frameTimeMsByAntialiasingQuality"), frameTimes},
+        {QStringLiteral("frameBudgetMs"), targetFrameBudgetMs()},
+        {QStringLiteral("missedFrames"), static_cast<qulonglong>(m_missedFrames)},
+        {QStringLiteral("presentIntervalMs"), m_presentIntervalMs.summary()},
+        {QStringLiteral("predictedPresentLeadMs"), m_predictedPresentLeadMs.summary()},
+        {QStringLiteral("gpuPasses"), m_gpuPassTimer->summary()},
+        {QStringLiteral("dynamicRenderScale"), m_dynamicRenderScale},
+        {QStringLiteral("renderScale"), m_renderScale},
+        {QStringLiteral("renderScaleChanges"), static_cast<qulonglong>(m_renderScaleChanges)},
+        {QStringLiteral("lookingAtScreenName"), m_lookingAtScreenName},
+        {QStringLiteral("peripheralTextureScale"), m_peripheralTextureScale},
+        {QStringLiteral("peripheralRefreshDivisor"), m_peripheralRefreshDivisor},
+        {QStringLiteral("peripheralRefreshesDeferred"), static_cast<qulonglong>(m_peripheralRefreshesDeferred)},
+        {QStringLiteral("poseIngestLatencyMs"), m_poseIngestLatencyMs.summary()},
+        {QStringLiteral("poseSamplesIngested"), static_cast<qulonglong>(m_poseSamplesIngested)},
+        {QStringLiteral("poseSamplesMissed"), static_cast<qulonglong>(m_poseSamplesMissed)},
+        {QStringLiteral("poseReadsUnchanged"), static_cast<qulonglong>(m_poseReadsUnchanged)},
+        {QStringLiteral("poseReadsTorn"), static_cast<qulonglong>(m_poseReader->tornReads())}
+    };
+}
+
 void BreezyDesktopEffect::warpPointerToOutputCenter(ScreenOutput *output)
 {
     if (!output) {
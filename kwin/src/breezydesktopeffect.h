@@ -1,24 +1,41 @@
 #pragma once
 
 #include "kcm/shortcuts.h"
+#include "kcm/virtualdisplayinfo.h"
+#include "rollingsamples.h"
 #include <effect/quickeffect.h>
 
 #include <QAction>
+#include <QElapsedTimer>
 #include <QFileSystemWatcher>
 #include <QImage>
 #include <QKeySequence>
 #include <QQuaternion>
 #include <QVariant>
 #include <QVariantList>
+#include <qqmlregistration.h>
 #include <QHash>
+#include <QMetaObject>
 #include <QRect>
+#include <QSet>
 #include <atomic>
+#include <memory>
 class QTimer;
 
+namespace BreezyPose
+{
+struct PoseSnapshot;
+class PoseReader;
+}
+
 namespace KWin
 {
     class BackendOutput;
+    class EffectWindow;
+    class ConfigWriter;
+    class GpuPassTimer;
     class LogicalOutput;
+    class MotionToPhotonMeter;
     class Output;
 
 #if defined(KWIN_VERSION_ENCODED) && KWIN_VERSION_ENCODED >= 60590
@@ -32,41 +49,49 @@ namespace KWin
     class BreezyDesktopEffect : public QuickSceneEffect
     {
         Q_OBJECT
-        Q_PROPERTY(bool isEnabled READ isEnabled NOTIFY enabledStateChanged)
-        Q_PROPERTY(int effectTargetScreenIndex READ effectTargetScreenIndex WRITE setEffectTargetScreenIndex)
-        Q_PROPERTY(bool zoomOnFocusEnabled READ isZoomOnFocusEnabled WRITE setZoomOnFocusEnabled NOTIFY zoomOnFocusChanged)
-        Q_PROPERTY(int lookingAtScreenIndex READ lookingAtScreenIndex WRITE setLookingAtScreenIndex)
-        Q_PROPERTY(bool poseResetState READ poseResetState NOTIFY poseResetStateChanged)
-        Q_PROPERTY(bool poseHasPosition READ poseHasPosition NOTIFY poseResetStateChanged)
-        Q_PROPERTY(QList<QQuaternion> poseOrientations READ poseOrientations)
-        Q_PROPERTY(QVector3D posePosition READ posePosition)
-        Q_PROPERTY(quint32 poseTimeElapsedMs READ poseTimeElapsedMs)
-        Q_PROPERTY(quint64 poseTimestamp READ poseTimestamp)
-        Q_PROPERTY(QString cursorImageSource READ cursorImageSource NOTIFY cursorImageSourceChanged)
-        Q_PROPERTY(QSize cursorImageSize READ cursorImageSize NOTIFY cursorImageSourceChanged)
-        Q_PROPERTY(QPointF cursorPos READ cursorPos NOTIFY cursorPosChanged)
-        Q_PROPERTY(QList<qreal> lookAheadConfig READ lookAheadConfig NOTIFY devicePropertiesChanged)
-        Q_PROPERTY(qreal lookAheadOverride READ lookAheadOverride WRITE setLookAheadOverride NOTIFY devicePropertiesChanged)
-        Q_PROPERTY(QList<quint32> displayResolution READ displayResolution NOTIFY devicePropertiesChanged)
-        Q_PROPERTY(qreal focusedDisplayDistance READ focusedDisplayDistance NOTIFY focusedDisplayDistanceChanged)
-        Q_PROPERTY(qreal allDisplaysDistance READ allDisplaysDistance NOTIFY allDisplaysDistanceChanged)
-        Q_PROPERTY(qreal displaySpacing READ displaySpacing NOTIFY displaySpacingChanged)
-        Q_PROPERTY(qreal displaySize READ displaySize NOTIFY displaySizeChanged)
-        Q_PROPERTY(qreal displayHorizontalOffset READ displayHorizontalOffset NOTIFY displayOffsetChanged)
-        Q_PROPERTY(qreal displayVerticalOffset READ displayVerticalOffset NOTIFY displayOffsetChanged)
-        Q_PROPERTY(int displayWrappingScheme READ displayWrappingScheme NOTIFY displayWrappingSchemeChanged)
-        Q_PROPERTY(qreal diagonalFOV READ diagonalFOV NOTIFY devicePropertiesChanged)
-        Q_PROPERTY(qreal lensDistanceRatio READ lensDistanceRatio NOTIFY devicePropertiesChanged)
-        Q_PROPERTY(bool sbsEnabled READ sbsEnabled NOTIFY sbsEnabledChanged)
-        Q_PROPERTY(bool smoothFollowEnabled READ smoothFollowEnabled NOTIFY smoothFollowEnabledChanged)
-        Q_PROPERTY(QList<QQuaternion> smoothFollowOrigin READ smoothFollowOrigin)
-        Q_PROPERTY(bool customBannerEnabled READ customBannerEnabled NOTIFY devicePropertiesChanged)
-        Q_PROPERTY(int antialiasingQuality READ antialiasingQuality NOTIFY antialiasingQualityChanged)
-        Q_PROPERTY(bool removeVirtualDisplaysOnDisable READ removeVirtualDisplaysOnDisable NOTIFY removeVirtualDisplaysOnDisableChanged)
-        Q_PROPERTY(bool mirrorPhysicalDisplays READ mirrorPhysicalDisplays NOTIFY mirrorPhysicalDisplaysChanged)
-        Q_PROPERTY(bool curvedDisplay READ curvedDisplay NOTIFY curvedDisplayChanged)
-        Q_PROPERTY(bool curvedDisplaySupported READ curvedDisplaySupported WRITE setCurvedDisplaySupported NOTIFY curvedDisplaySupportedChanged)
-        Q_PROPERTY(bool developerMode READ developerMode NOTIFY developerModeChanged)
+        // declared in the scene's QML module so qmlcachegen knows the effect's properties when it compiles the scene
+        QML_NAMED_ELEMENT(BreezyDesktopEffect)
+        QML_UNCREATABLE("BreezyDesktop cannot be created in QML")
+        Q_PROPERTY(bool isEnabled READ isEnabled NOTIFY enabledStateChanged FINAL)
+        Q_PROPERTY(int effectTargetScreenIndex READ effectTargetScreenIndex WRITE setEffectTargetScreenIndex FINAL)
+        Q_PROPERTY(bool zoomOnFocusEnabled READ isZoomOnFocusEnabled WRITE setZoomOnFocusEnabled NOTIFY zoomOnFocusChanged FINAL)
+        Q_PROPERTY(int lookingAtScreenIndex READ lookingAtScreenIndex WRITE setLookingAtScreenIndex FINAL)
+        Q_PROPERTY(QString lookingAtScreenName READ lookingAtScreenName WRITE setLookingAtScreenName NOTIFY lookingAtScreenNameChanged FINAL)
+        Q_PROPERTY(qreal peripheralTextureScale READ peripheralTextureScale NOTIFY peripheralQualityChanged FINAL)
+        Q_PROPERTY(bool poseResetState READ poseResetState NOTIFY poseResetStateChanged FINAL)
+        Q_PROPERTY(bool poseHasPosition READ poseHasPosition NOTIFY poseResetStateChanged FINAL)
+        Q_PROPERTY(QList<QQuaternion> poseOrientations READ poseOrientations FINAL)
+        Q_PROPERTY(QVector3D posePosition READ posePosition FINAL)
+        Q_PROPERTY(quint32 poseTimeElapsedMs READ poseTimeElapsedMs FINAL)
+        Q_PROPERTY(quint64 poseTimestamp READ poseTimestamp FINAL)
+        Q_PROPERTY(qreal predictedPresentTimestamp READ predictedPresentTimestamp FINAL)
+        Q_PROPERTY(QString cursorImageSource READ cursorImageSource NOTIFY cursorImageSourceChanged FINAL)
+        Q_PROPERTY(QSize cursorImageSize READ cursorImageSize NOTIFY cursorImageSourceChanged FINAL)
+        Q_PROPERTY(QPointF cursorPos READ cursorPos NOTIFY cursorPosChanged FINAL)
+        Q_PROPERTY(QList<qreal> lookAheadConfig READ lookAheadConfig NOTIFY devicePropertiesChanged FINAL)
+        Q_PROPERTY(qreal lookAheadOverride READ lookAheadOverride WRITE setLookAheadOverride NOTIFY devicePropertiesChanged FINAL)
+        Q_PROPERTY(QList<quint32> displayResolution READ displayResolution NOTIFY devicePropertiesChanged FINAL)
+        Q_PROPERTY(qreal focusedDisplayDistance READ focusedDisplayDistance NOTIFY focusedDisplayDistanceChanged FINAL)
+        Q_PROPERTY(qreal allDisplaysDistance READ allDisplaysDistance NOTIFY allDisplaysDistanceChanged FINAL)
+        Q_PROPERTY(qreal displaySpacing READ displaySpacing NOTIFY displaySpacingChanged FINAL)
+        Q_PROPERTY(qreal displaySize READ displaySize NOTIFY displaySizeChanged FINAL)
+        Q_PROPERTY(qreal displayHorizontalOffset READ displayHorizontalOffset NOTIFY displayOffsetChanged FINAL)
+        Q_PROPERTY(qreal displayVerticalOffset READ displayVerticalOffset NOTIFY displayOffsetChanged FINAL)
+        Q_PROPERTY(int displayWrappingScheme READ displayWrappingScheme NOTIFY displayWrappingSchemeChanged FINAL)
+        Q_PROPERTY(qreal diagonalFOV READ diagonalFOV NOTIFY devicePropertiesChanged FINAL)
+        Q_PROPERTY(qreal lensDistanceRatio READ lensDistanceRatio NOTIFY devicePropertiesChanged FINAL)
+        Q_PROPERTY(bool sbsEnabled READ sbsEnabled NOTIFY sbsEnabledChanged FINAL)
+        Q_PROPERTY(bool smoothFollowEnabled READ smoothFollowEnabled NOTIFY smoothFollowEnabledChanged FINAL)
+        Q_PROPERTY(QList<QQuaternion> smoothFollowOrigin READ smoothFollowOrigin FINAL)
+        Q_PROPERTY(bool customBannerEnabled READ customBannerEnabled NOTIFY devicePropertiesChanged FINAL)
+        Q_PROPERTY(int antialiasingQuality READ antialiasingQuality NOTIFY antialiasingQualityChanged FINAL)
+        Q_PROPERTY(int textureFiltering READ textureFiltering NOTIFY textureFilteringChanged FINAL)
+        Q_PROPERTY(qreal renderScale READ renderScale NOTIFY renderScaleChanged FINAL)
+        Q_PROPERTY(bool removeVirtualDisplaysOnDisable READ removeVirtualDisplaysOnDisable NOTIFY removeVirtualDisplaysOnDisableChanged FINAL)
+        Q_PROPERTY(bool mirrorPhysicalDisplays READ mirrorPhysicalDisplays NOTIFY mirrorPhysicalDisplaysChanged FINAL)
+        Q_PROPERTY(bool curvedDisplay READ curvedDisplay NOTIFY curvedDisplayChanged FINAL)
+        Q_PROPERTY(bool curvedDisplaySupported READ curvedDisplaySupported WRITE setCurvedDisplaySupported NOTIFY curvedDisplaySupportedChanged FINAL)
+        Q_PROPERTY(bool developerMode READ developerMode NOTIFY developerModeChanged FINAL)
 
 
     public:
@@ -75,6 +100,8 @@ namespace KWin
         ~BreezyDesktopEffect() override;
 
         void reconfigure(ReconfigureFlags) override;
+        void prePaintScreen(ScreenPrePaintData &data, std::chrono::milliseconds presentTime) override;
+        void postPaintScreen() override;
 
         int requestedEffectChainPosition() const override;
 
@@ -89,10 +116,14 @@ namespace KWin
         void setZoomOnFocusEnabled(bool enabled);
         int lookingAtScreenIndex() const { return m_lookingAtScreenIndex; }
         void setLookingAtScreenIndex(int index);
+        QString lookingAtScreenName() const { return m_lookingAtScreenName; }
+        void setLookingAtScreenName(const QString &name);
+        qreal peripheralTextureScale() const;
         QList<QQuaternion> poseOrientations() const;
         QVector3D posePosition() const;
         quint32 poseTimeElapsedMs() const;
         quint64 poseTimestamp() const;
+        qreal predictedPresentTimestamp() const;
         bool poseResetState() const;
         bool poseHasPosition() const;
         QList<qreal> lookAheadConfig() const;
@@ -117,6 +148,8 @@ namespace KWin
         QList<QQuaternion> smoothFollowOrigin() const;
         bool customBannerEnabled() const;
         int antialiasingQuality() const;
+        int textureFiltering() const;
+        qreal renderScale() const;
         bool removeVirtualDisplaysOnDisable() const;
         bool mirrorPhysicalDisplays() const;
         bool curvedDisplay() const;
@@ -132,12 +165,24 @@ namespace KWin
         void enableDriver();
         void disableDriver();
         void toggle();
-        void addVirtualDisplay(QSize size);
+        void addVirtualDisplay(QSize size, qreal scale = 1.0);
+        void addVirtualDisplays(const BreezyVirtualDisplays::VirtualDisplayInfoList &displays);
         void updatePose();
         void updateCursorImage();
         void updateCursorPos();
-        QVariantList listVirtualDisplays() const;
+        BreezyVirtualDisplays::VirtualDisplayInfoList listVirtualDisplays() const;
         bool removeVirtualDisplay(const QString &id);
+        QStringList virtualDisplayLayoutNames() const;
+        QString activeVirtualDisplayLayout() const;
+        bool saveVirtualDisplayLayout(const QString &name);
+        bool restoreVirtualDisplayLayout(const QString &name);
+        bool removeVirtualDisplayLayout(const QString &name);
+        QVariantMap renderStats() const;
+        QVariantMap startupProfile() const;
+        QVariantMap poseState() const;
+        QVariantMap motionToPhotonStats() const;
+        QString writeMotionToPhotonCsv(const QString &path) const;
+        void resetMotionToPhoton();
         void moveCursorToFocusedDisplay();
         bool curvedDisplaySupported() const;
 
@@ -157,7 +202,17 @@ namespace KWin
         void smoothFollowEnabledChanged();
         void devicePropertiesChanged();
         void antialiasingQualityChanged();
+        void textureFilteringChanged();
+        void renderScaleChanged();
+        void lookingAtScreenNameChanged();
+
+        // emitted once per effect frame, before it's painted, after predictedPresentTimestamp is updated
+        void framePrepared();
+        void peripheralQualityChanged();
         void removeVirtualDisplaysOnDisableChanged();
+
+        // emitted whenever a virtual display is added or removed, including the bulk removal on disable
+        void virtualDisplaysChanged();
         void mirrorPhysicalDisplaysChanged();
         void curvedDisplayChanged();
         void curvedDisplaySupportedChanged();
@@ -165,14 +220,23 @@ namespace KWin
         void cursorImageSourceChanged();
         void cursorPosChanged();
 
+        // rate-limited to POSE_PUBLISH_INTERVAL_MS, for out-of-process consumers of poseState()
+        void posePublished();
+
+        // emitted at most once per frame with the names of the screens whose display texture needs to be re-rendered
+        void displayTexturesDamaged(const QStringList &screenNames);
+
     protected:
         QVariantMap initialProperties(ScreenOutput *screen) override;
 
     private:
         void teardown();
-        bool checkParityByte(const char* data);
         void setupGlobalShortcut(const BreezyShortcuts::Shortcut &shortcut, 
                                  std::function<void()> triggeredFunc);
+        void ensureInitialized();
+        void requestDriverFeatures();
+        void recordPoseIngest(const BreezyPose::PoseSnapshot &pose, qint64 currentTimeMs);
+        void recordStartupPhase(const QString &name, qint64 startNs);
         void recenter();
         void toggleSmoothFollow();
         void setSmoothFollowThreshold(float threshold);
@@ -181,6 +245,24 @@ namespace KWin
         void evaluateCursorOnScreenState(const QPointF &prevPos, const QPointF &newPos);
         void invalidateEffectOnScreenGeometryCache();
         bool updateEffectOnScreenGeometryCache();
+        bool isEffectTargetScreen(const ScreenOutput *screen) const;
+        void connectDamageTracking();
+        void disconnectDamageTracking();
+        void trackWindowDamage(EffectWindow *window);
+        void untrackWindowDamage(EffectWindow *window);
+        void markScreensDamaged(const QRectF &geometry);
+        void markAllScreensDamaged();
+        void flushDisplayTextureDamage();
+        qreal targetFrameBudgetMs() const;
+        void scheduleEffectFrame();
+        void logFramePacing();
+        void updateRenderScale(double frameCostMs);
+        QString nextVirtualDisplayId() const;
+        VirtualOutputHandle *createVirtualOutput(const QString &id, QSize size, qreal scale);
+        void setVirtualOutputsEnabled(const QList<VirtualOutputHandle *> &outputs, bool enabled);
+        void scheduleVirtualDisplayPoolRefill();
+        void refillVirtualDisplayPool();
+        void clearVirtualDisplayPool();
 
         QString m_cursorImageSource;
         QSize m_cursorImageSize;
@@ -195,6 +277,8 @@ namespace KWin
         QVector3D m_posePosition;
         quint32 m_poseTimeElapsedMs = 0;
         quint64 m_poseTimestamp = 0;
+        static constexpr qint64 POSE_PUBLISH_INTERVAL_MS = 100;
+        qint64 m_posePublishedAtMs = 0;
         QList<qreal> m_lookAheadConfig;
         qreal m_lookAheadOverride = -1.0; // -1 = use device default
         QList<quint32> m_displayResolution;
@@ -206,6 +290,7 @@ namespace KWin
         bool m_customBannerEnabled = false;
         QFileSystemWatcher *m_shmFileWatcher = nullptr;
         QFileSystemWatcher *m_shmDirectoryWatcher = nullptr;
+        std::unique_ptr<BreezyPose::PoseReader> m_poseReader;
         bool m_cursorHidden = false;
         QPointF m_cursorPos;
         QTimer *m_cursorUpdateTimer = nullptr;
@@ -219,7 +304,8 @@ namespace KWin
         qreal m_displayHorizontalOffset = 0.0;
         qreal m_displayVerticalOffset = 0.0;
         int m_displayWrappingScheme = 0; // 0=auto,1=horizontal,2=vertical,3=flat
-        int m_antialiasingQuality = 3; // 0=None, 1=Medium, 2=High, 3=VeryHigh
+        int m_antialiasingQuality = 3; // 0=None, 1-3=SSAA Medium/High/VeryHigh, 4=MSAA, 5=Temporal, 6=Filtered sampling
+        int m_textureFiltering = 0; // 0=None, 1=Mipmaps, 2=Mipmaps + anisotropic
         bool m_removeVirtualDisplaysOnDisable = true;
         bool m_mirrorPhysicalDisplays = false;
         bool m_curvedDisplay = false;
@@ -229,6 +315,75 @@ namespace KWin
         bool m_allDisplaysFollowMode = false;
         bool m_focusedSmoothFollowEnabled = false;
 
+        // Damage tracking for the per-display textures, flushed once per frame of the effect target screen
+        QSet<QString> m_damagedScreens;
+        QList<QMetaObject::Connection> m_damageConnections;
+        QHash<EffectWindow *, QList<QMetaObject::Connection>> m_windowDamageConnections;
+        quint64 m_framesRendered = 0;
+        quint64 m_displayTexturesRefreshed = 0;
+        RollingSamples m_displayTexturesRefreshedPerFrame;
+        QElapsedTimer m_effectFrameTimer;
+        bool m_effectFrameTiming = false;
+        QHash<int, RollingSamples> m_effectFrameTimeByAntialiasingMode;
+
+        // Frame-time governor for the 3D scene's render resolution
+        bool m_dynamicRenderScale = false;
+        qreal m_renderScaleMin = 0.5;
+        qreal m_renderScaleMax = 1.0;
+        qreal m_renderScale = 1.0;
+        std::chrono::milliseconds m_lastEffectPresentTime{0};
+        bool m_lastEffectFrameMissed = false;
+        quint64 m_missedFrames = 0;
+        int m_renderScaleWindowMisses = 0;
+        int m_renderScaleCleanWindows = 0;
+        RollingSamples m_renderScaleWindow{60};
+        RollingSamples m_renderScaleGpuWindow{60};
+        quint64 m_renderScaleChanges = 0;
+
+        // Pose ingest: how old each new block is when it's read, and how many samples the driver wrote that were
+        // overwritten before updatePose() got to them, judged from the sample timestamps kept in the block
+        RollingSamples m_poseIngestLatencyMs;
+        quint64 m_poseSamplesIngested = 0;
+        quint64 m_poseSamplesMissed = 0;
+        quint64 m_poseReadsUnchanged = 0;
+        float m_lastIngestedSampleMs = 0.0f;
+
+        // Reduced texture resolution and refresh rate for the displays that aren't being looked at
+        QString m_lookingAtScreenName;
+        qreal m_peripheralTextureScale = 1.0;
+        int m_peripheralRefreshDivisor = 1;
+        quint64 m_peripheralRefreshesDeferred = 0;
+
+        // Frame pacing from KWin's presentation timing
+        qreal m_predictedPresentTimestamp = 0.0;
+        RollingSamples m_presentIntervalMs;
+        RollingSamples m_predictedPresentLeadMs;
+        quint64 m_missedFramesLogged = 0;
+        quint64 m_framesAtLastPacingLog = 0;
+
+        // Startup profile: offsets and durations of each construction phase and of the deferred initialization,
+        // measured from the start of the constructor
+        struct StartupPhase {
+            QString name;
+            qint64 startNs = 0;
+            qint64 durationNs = 0;
+        };
+        QElapsedTimer m_startupClock;
+        QList<StartupPhase> m_startupPhases;
+        bool m_initialized = false;
+        bool m_driverFeaturesRequested = false;
+
+        // config values changed from inside the effect are written through this rather than a synchronous save()
+        ConfigWriter *m_configWriter = nullptr;
+        // every config item as of the last reconfigure, so re-reading an unchanged file is a no-op
+        QVariantMap m_configSnapshot;
+
+        // GL timestamp queries around the effect window's render stages, for developerMode and the render scale governor
+        GpuPassTimer *m_gpuPassTimer = nullptr;
+
+        // developerMode only: pose age at presentation for each effect frame
+        MotionToPhotonMeter *m_motionToPhoton = nullptr;
+
         // Cached geometry for on-screen cursor evaluation
         QRect m_effectOnScreenExpandedGeometry;
         bool m_effectOnScreenGeometryValid = false;
@@ -237,8 +392,22 @@ namespace KWin
             VirtualOutputHandle *output = nullptr;
             QString id;
             QSize size;
+            qreal scale = 1.0;
+            quint64 order = 0; // creation order, which is the order displays are listed and saved in
         };
+        QList<VirtualOutputInfo> orderedVirtualDisplays() const;
         QHash<QString, VirtualOutputInfo> m_virtualDisplays;
+        quint64 m_virtualDisplaySequence = 0;
+
+        // named layout restored in one batch on activation; empty for none
+        QString m_activeVirtualDisplayLayout;
+
+        // Warm pool: virtual outputs created ahead of time and kept disabled, so adding a display of the
+        // pooled size only has to enable an existing output. Only kept while the effect is active.
+        int m_virtualDisplayPoolCount = 0;
+        QSize m_virtualDisplayPoolResolution{1920, 1080}; // follows the most recently added size
+        QList<VirtualOutputInfo> m_virtualDisplayPool;
+        QTimer *m_virtualDisplayPoolTimer = nullptr;
     };
 
 } // namespace KWin
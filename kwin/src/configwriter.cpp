@@ -0,0 +1,73 @@
+#include "configwriter.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KCoreConfigSkeleton>
+
+#include <QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(KWIN_XR)
+
+namespace KWin
+{
+
+ConfigWriter::ConfigWriter(KCoreConfigSkeleton *skeleton, QObject *parent)
+    : QObject(parent)
+    , m_skeleton(skeleton)
+    , m_fileName(skeleton->config()->name())
+{
+    m_coalesceTimer.setSingleShot(true);
+    m_coalesceTimer.setInterval(250);
+    connect(&m_coalesceTimer, &QTimer::timeout, this, &ConfigWriter::writePending);
+
+    // one writer thread keeps the writes in the order they were queued
+    m_writerPool.setMaxThreadCount(1);
+}
+
+ConfigWriter::~ConfigWriter()
+{
+    flush();
+}
+
+void ConfigWriter::queue(const QString &itemName)
+{
+    KConfigSkeletonItem *item = m_skeleton->findItem(itemName);
+    if (!item) {
+        qCWarning(KWIN_XR) << "Breezy - no config item named" << itemName;
+        return;
+    }
+
+    m_pending.insert(itemName, {item->group(), item->key(), item->property()});
+    if (!m_coalesceTimer.isActive()) {
+        m_coalesceTimer.start();
+    }
+}
+
+void ConfigWriter::flush()
+{
+    m_coalesceTimer.stop();
+    writePending();
+    m_writerPool.waitForDone();
+}
+
+void ConfigWriter::writePending()
+{
+    if (m_pending.isEmpty()) return;
+
+    const QList<PendingEntry> entries = m_pending.values();
+    m_pending.clear();
+    const QString fileName = m_fileName;
+    m_writerPool.start([fileName, entries]() {
+        // KSharedConfig isn't safe to share across threads, so the write gets its own instance
+        KConfig config(fileName, KConfig::NoGlobals);
+        for (const auto &entry : entries) {
+            KConfigGroup group(&config, entry.group);
+            group.writeEntry(entry.key.toUtf8().constData(), entry.value, KConfig::Notify | KConfig::Persistent);
+        }
+        if (!config.sync()) {
+            qCWarning(KWIN_XR) << "Breezy - failed to write" << entries.size() << "config entries to" << fileName;
+        }
+    });
+}
+
+} // namespace KWin
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariant>
+
+class KCoreConfigSkeleton;
+
+namespace KWin
+{
+
+// Persists config values changed from inside the compositor without blocking it. Items queued within a
+// short window are coalesced into one write, which runs on a background thread against its own KConfig
+// instance and is sent with KConfig::Notify so the KCM's watcher still sees it.
+//
+// The skeleton itself is only used to look up keys and current values; callers update it with the
+// generated mutators first, so in-process readers see the new value immediately.
+class ConfigWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConfigWriter(KCoreConfigSkeleton *skeleton, QObject *parent = nullptr);
+    ~ConfigWriter() override;
+
+    // item name as in the kcfg file, e.g. "ZoomOnFocusEnabled"
+    void queue(const QString &itemName);
+
+    // writes anything still queued and waits for writes in flight, e.g. before re-reading the config file
+    void flush();
+
+private:
+    struct PendingEntry {
+        QString group;
+        QString key;
+        QVariant value;
+    };
+
+    void writePending();
+
+    KCoreConfigSkeleton *m_skeleton;
+    QString m_fileName;
+    QTimer m_coalesceTimer;
+    QHash<QString, PendingEntry> m_pending;
+    QThreadPool m_writerPool;
+};
+
+} // namespace KWin
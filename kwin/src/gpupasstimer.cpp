@@ -0,0 +1,168 @@
+#include "gpupasstimer.h"
+
+#include <QLoggingCategory>
+#include <QQuickWindow>
+
+#include <epoxy/gl.h>
+
+Q_DECLARE_LOGGING_CATEGORY(KWIN_XR)
+
+namespace KWin
+{
+
+GpuPassTimer::GpuPassTimer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+GpuPassTimer::~GpuPassTimer()
+{
+    // the GL context may already be gone here, so the queries are only forgotten
+    detach();
+}
+
+void GpuPassTimer::attach(QQuickWindow *window)
+{
+    if (isAttachedTo(window)) return;
+    detach();
+    if (!window) return;
+
+    m_window = window;
+
+    // the effect's windows render on the compositor thread, so these fire with its GL context current
+    m_connections << connect(window, &QQuickWindow::beforeRendering, this, [this]() {
+        collect();
+        stamp(FrameStart);
+    }, Qt::DirectConnection);
+    m_connections << connect(window, &QQuickWindow::beforeRenderPassRecording, this, [this]() {
+        stamp(MainPassStart);
+    }, Qt::DirectConnection);
+    m_connections << connect(window, &QQuickWindow::afterRenderPassRecording, this, [this]() {
+        stamp(MainPassEnd);
+    }, Qt::DirectConnection);
+    m_connections << connect(window, &QQuickWindow::afterRendering, this, [this]() {
+        stamp(FrameEnd);
+        if (m_queriesCreated) {
+            m_frames[m_currentFrame].pending = true;
+            m_currentFrame = (m_currentFrame + 1) % FramesInFlight;
+        }
+    }, Qt::DirectConnection);
+    m_connections << connect(window, &QQuickWindow::sceneGraphInvalidated, this, &GpuPassTimer::releaseQueries, Qt::DirectConnection);
+}
+
+void GpuPassTimer::detach()
+{
+    for (const auto &connection : std::as_const(m_connections)) {
+        disconnect(connection);
+    }
+    m_connections.clear();
+    m_window.clear();
+    forgetQueries();
+}
+
+bool GpuPassTimer::isAttachedTo(const QQuickWindow *window) const
+{
+    return window && m_window == window;
+}
+
+bool GpuPassTimer::ensureQueries()
+{
+    if (m_queriesCreated) return true;
+    if (!m_supported) return false;
+
+    // timestamp queries need desktop GL 3.3 or ARB_timer_query; GLES only has them behind a disjoint-timer extension
+    m_supported = epoxy_is_desktop_gl() && (epoxy_gl_version() >= 33 || epoxy_has_gl_extension("GL_ARB_timer_query"));
+    if (!m_supported) {
+        qCWarning(KWIN_XR) << "Breezy - GPU timer queries aren't supported by this GL context";
+        return false;
+    }
+
+    for (auto &frame : m_frames) {
+        glGenQueries(StampCount, frame.queries.data());
+        frame.pending = false;
+    }
+    m_currentFrame = 0;
+    m_queriesCreated = true;
+    return true;
+}
+
+void GpuPassTimer::releaseQueries()
+{
+    if (!m_queriesCreated) return;
+
+    for (auto &frame : m_frames) {
+        glDeleteQueries(StampCount, frame.queries.data());
+    }
+    forgetQueries();
+}
+
+// Drops the query names without deleting them. On detach the names belong to the old window's GL context, which
+// isn't current and may already be gone, so deleting them could hit another context's objects; they go away with
+// that context instead, and the next window creates its own.
+void GpuPassTimer::forgetQueries()
+{
+    for (auto &frame : m_frames) {
+        frame.queries.fill(0);
+        frame.pending = false;
+    }
+    m_currentFrame = 0;
+    m_queriesCreated = false;
+}
+
+void GpuPassTimer::stamp(Stamp stamp)
+{
+    if (!m_window) return;
+
+    // QRhi's GL backend queues the frame's commands and only issues them at the end of the frame; starting external
+    // commands flushes what's been queued so far, so the query lands after the work recorded before it rather than
+    // ahead of the whole frame
+    m_window->beginExternalCommands();
+    if (ensureQueries()) {
+        Frame &frame = m_frames[m_currentFrame];
+        if (stamp == FrameStart && frame.pending) {
+            // the GPU is more than FramesInFlight frames behind; drop the oldest result rather than stall
+            frame.pending = false;
+            ++m_framesDropped;
+        }
+        glQueryCounter(frame.queries[stamp], GL_TIMESTAMP);
+    }
+    m_window->endExternalCommands();
+}
+
+void GpuPassTimer::collect()
+{
+    if (!m_queriesCreated) return;
+
+    for (auto &frame : m_frames) {
+        if (!frame.pending) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[FrameEnd], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        std::array<GLuint64, StampCount> timestamps{};
+        for (int i = 0; i < StampCount; ++i) {
+            glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+        }
+        frame.pending = false;
+
+        m_offscreenMs.add((timestamps[MainPassStart] - timestamps[FrameStart]) / 1e6);
+        m_mainPassMs.add((timestamps[MainPassEnd] - timestamps[MainPassStart]) / 1e6);
+        m_totalMs.add((timestamps[FrameEnd] - timestamps[FrameStart]) / 1e6);
+        Q_EMIT frameTimed(m_totalMs.last());
+    }
+}
+
+QVariantMap GpuPassTimer::summary() const
+{
+    return QVariantMap{
+        {QStringLiteral("supported"), m_supported},
+        {QStringLiteral("attached"), !m_window.isNull()},
+        {QStringLiteral("offscreenMs"), m_offscreenMs.summary()},
+        {QStringLiteral("mainPassMs"), m_mainPassMs.summary()},
+        {QStringLiteral("totalMs"), m_totalMs.summary()},
+        {QStringLiteral("framesDropped"), static_cast<qulonglong>(m_framesDropped)}
+    };
+}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "rollingsamples.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QVariantMap>
+
+#include <array>
+
+class QQuickWindow;
+
+namespace KWin
+{
+
+// GL timestamp queries around the render stages of the effect's QtQuick window. Results are read back a few
+// frames later so the CPU never waits on the GPU.
+//
+// Offscreen covers everything rendered before the window's own pass: the display texture captures, the 3D scene and
+// its antialiasing resolve. These can't be told apart from outside Qt: they all run in the scene graph's preprocess
+// step, which visits the ShaderEffectSources and the View3D in no defined order and emits nothing in between. Main
+// pass is the window's own pass, which draws the (possibly scaled) View3D output.
+class GpuPassTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GpuPassTimer(QObject *parent = nullptr);
+    ~GpuPassTimer() override;
+
+    void attach(QQuickWindow *window);
+    void detach();
+    bool isAttachedTo(const QQuickWindow *window) const;
+
+    QVariantMap summary() const;
+
+Q_SIGNALS:
+    // emitted as each frame's results are read back, a few frames after it was rendered
+    void frameTimed(double totalMs);
+
+private:
+    enum Stamp {
+        FrameStart,
+        MainPassStart,
+        MainPassEnd,
+        FrameEnd,
+        StampCount,
+    };
+
+    struct Frame {
+        std::array<unsigned int, StampCount> queries{};
+        bool pending = false;
+    };
+
+    static constexpr int FramesInFlight = 4;
+
+    bool ensureQueries();
+    void releaseQueries();
+    void forgetQueries();
+    void stamp(Stamp stamp);
+    void collect();
+
+    QPointer<QQuickWindow> m_window;
+    QList<QMetaObject::Connection> m_connections;
+    std::array<Frame, FramesInFlight> m_frames{};
+    int m_currentFrame = 0;
+    bool m_queriesCreated = false;
+    bool m_supported = true;
+    quint64 m_framesDropped = 0;
+
+    RollingSamples m_offscreenMs;
+    RollingSamples m_mainPassMs;
+    RollingSamples m_totalMs;
+};
+
+}
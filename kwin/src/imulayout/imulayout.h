@@ -0,0 +1,215 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// The driver's shared memory pose block, declared once. The effect, the KCM and the tools decode it through View;
+// the GNOME extension gets the same offsets from imulayout.js, which breezy_imu_layout_js generates from FIELDS.
+// Header only and Qt free, so anything that reads the block can use it.
+namespace ImuLayout
+{
+    inline constexpr char SHM_PATH[] = "/dev/shm/breezy_desktop_imu";
+
+    // the only version these definitions describe, bumped by the driver whenever the layout changes
+    constexpr uint8_t CURRENT_VERSION = 5;
+
+    // rows in each orientation block: three quaternions, newest first, then a row with their timestamps in ms
+    constexpr int ORIENTATION_ROWS = 4;
+    constexpr int ORIENTATION_QUATERNIONS = 3;
+
+#pragma pack(push, 1)
+    // Version 5, byte for byte as the driver writes it. Multi-byte values are little-endian.
+    struct BlockV5 {
+        uint8_t version;
+        uint8_t enabled;
+        float lookAheadConfig[4];
+        uint32_t displayResolution[2];
+        float displayFov;
+        float lensDistanceRatio;
+        uint8_t sbsEnabled;
+        uint8_t customBannerEnabled;
+        uint8_t smoothFollowEnabled;
+        float smoothFollowOrigin[4 * ORIENTATION_ROWS];
+        float posePosition[3];
+        uint32_t poseDateMs[2]; // one uint64, declared as the two words the driver writes
+        float poseOrientation[4 * ORIENTATION_ROWS];
+        uint8_t parity; // XOR of the poseDateMs and poseOrientation bytes
+    };
+#pragma pack(pop)
+
+    using Block = BlockV5;
+
+    static_assert(std::is_standard_layout_v<Block>, "offsetof needs a standard layout block");
+    static_assert(sizeof(Block) == 186, "the version 5 block is 186 bytes, a field was added, removed or resized");
+    static_assert(offsetof(Block, poseDateMs) == 113 && offsetof(Block, poseOrientation) == 121 && offsetof(Block, parity) == 185,
+                  "the fields the parity covers have moved");
+
+    // [offset, element size, count], the form the GNOME extension's DataView helpers take
+    struct Field {
+        const char *name;
+        size_t offset;
+        size_t elementSize;
+        size_t count;
+    };
+
+    template<typename T>
+    constexpr size_t fieldElementSize = sizeof(std::remove_all_extents_t<T>);
+
+    template<typename T>
+    constexpr size_t fieldCount = sizeof(T) / fieldElementSize<T>;
+
+#define BREEZY_IMU_LAYOUT_FIELD(name, member) \
+    Field{name, offsetof(Block, member), fieldElementSize<decltype(Block::member)>, fieldCount<decltype(Block::member)>}
+
+    // every field in order, named as the GNOME extension has always named them
+    constexpr std::array FIELDS = {
+        BREEZY_IMU_LAYOUT_FIELD("VERSION", version),
+        BREEZY_IMU_LAYOUT_FIELD("ENABLED", enabled),
+        BREEZY_IMU_LAYOUT_FIELD("LOOK_AHEAD_CFG", lookAheadConfig),
+        BREEZY_IMU_LAYOUT_FIELD("DISPLAY_RES", displayResolution),
+        BREEZY_IMU_LAYOUT_FIELD("DISPLAY_FOV", displayFov),
+        BREEZY_IMU_LAYOUT_FIELD("LENS_DISTANCE_RATIO", lensDistanceRatio),
+        BREEZY_IMU_LAYOUT_FIELD("SBS_ENABLED", sbsEnabled),
+        BREEZY_IMU_LAYOUT_FIELD("CUSTOM_BANNER_ENABLED", customBannerEnabled),
+        BREEZY_IMU_LAYOUT_FIELD("SMOOTH_FOLLOW_ENABLED", smoothFollowEnabled),
+        BREEZY_IMU_LAYOUT_FIELD("SMOOTH_FOLLOW_ORIGIN_DATA", smoothFollowOrigin),
+        BREEZY_IMU_LAYOUT_FIELD("POSE_POSITION", posePosition),
+        BREEZY_IMU_LAYOUT_FIELD("EPOCH_MS", poseDateMs),
+        BREEZY_IMU_LAYOUT_FIELD("POSE_ORIENTATION", poseOrientation),
+        BREEZY_IMU_LAYOUT_FIELD("IMU_PARITY_BYTE", parity),
+    };
+
+#undef BREEZY_IMU_LAYOUT_FIELD
+
+    constexpr bool fieldsCoverBlock() {
+        size_t end = 0;
+        for (const Field &field : FIELDS) {
+            if (field.offset != end) return false;
+            end = field.offset + field.elementSize * field.count;
+        }
+        return end == sizeof(Block);
+    }
+    static_assert(fieldsCoverBlock(), "FIELDS must list every member of Block, in order");
+
+    // as stored by the driver: north-west-up, scalar last
+    struct Quaternion {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 1.0f;
+    };
+
+    struct Vector3 {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+    };
+
+    // NWU to the east-up-south frame the renderers use: (x, y, z) becomes (-y, z, -x)
+    constexpr Vector3 nwuToEus(Vector3 v) {
+        return {-v.y, v.z, -v.x};
+    }
+
+    constexpr Quaternion nwuToEus(Quaternion q) {
+        return {-q.y, q.z, -q.x, q.w};
+    }
+
+    // XOR of the poseDateMs and poseOrientation bytes of a whole block
+    inline uint8_t parityOf(const unsigned char *block) {
+        uint8_t parity = 0;
+        for (size_t i = 0; i < sizeof(Block::poseDateMs); ++i) parity ^= block[offsetof(Block, poseDateMs) + i];
+        for (size_t i = 0; i < sizeof(Block::poseOrientation); ++i) parity ^= block[offsetof(Block, poseOrientation) + i];
+        return parity;
+    }
+
+    // Rewrites a block's poseDateMs and refreshes its parity byte, for the tools that replay or synthesize blocks
+    inline void stampPoseDateMs(unsigned char *block, uint64_t poseDateMs) {
+        for (size_t i = 0; i < sizeof(Block::poseDateMs); ++i) {
+            block[offsetof(Block, poseDateMs) + i] = static_cast<unsigned char>(poseDateMs >> (8 * i));
+        }
+        block[offsetof(Block, parity)] = parityOf(block);
+    }
+
+    // Typed, read-only view over a block. Nothing is copied up front: each accessor reads its field straight from
+    // the buffer, so the buffer has to outlive the view and should be a private copy if the driver may be writing.
+    class View
+    {
+    public:
+        // anything but exactly one block leaves the view invalid
+        constexpr View(const void *data, size_t size)
+            : m_data(data && size == sizeof(Block) ? static_cast<const unsigned char *>(data) : nullptr)
+        {
+        }
+
+        bool isValid() const { return m_data != nullptr; }
+
+        uint8_t version() const { return read<uint8_t>(offsetof(Block, version)); }
+        bool isCurrentVersion() const { return version() == CURRENT_VERSION; }
+        bool enabled() const { return read<uint8_t>(offsetof(Block, enabled)) != 0; }
+
+        // false means the block was caught mid-write
+        bool parityMatches() const { return parityOf(m_data) == m_data[offsetof(Block, parity)]; }
+
+        std::array<float, 4> lookAheadConfig() const { return readArray<float, 4>(offsetof(Block, lookAheadConfig)); }
+        std::array<uint32_t, 2> displayResolution() const { return readArray<uint32_t, 2>(offsetof(Block, displayResolution)); }
+        float displayFov() const { return read<float>(offsetof(Block, displayFov)); }
+        float lensDistanceRatio() const { return read<float>(offsetof(Block, lensDistanceRatio)); }
+        bool sbsEnabled() const { return read<uint8_t>(offsetof(Block, sbsEnabled)) != 0; }
+        bool customBannerEnabled() const { return read<uint8_t>(offsetof(Block, customBannerEnabled)) != 0; }
+        bool smoothFollowEnabled() const { return read<uint8_t>(offsetof(Block, smoothFollowEnabled)) != 0; }
+        uint64_t poseDateMs() const { return read<uint64_t>(offsetof(Block, poseDateMs)); }
+
+        // NWU, in the units the driver writes; multiply by the scene's full screen distance to place it
+        Vector3 posePosition() const {
+            const auto v = readArray<float, 3>(offsetof(Block, posePosition));
+            return {v[0], v[1], v[2]};
+        }
+
+        // row 0 is the newest sample, up to ORIENTATION_QUATERNIONS - 1
+        Quaternion poseOrientation(int row) const { return quaternionAt(offsetof(Block, poseOrientation), row); }
+        Quaternion smoothFollowOrigin(int row) const { return quaternionAt(offsetof(Block, smoothFollowOrigin), row); }
+
+        // the timestamp row of the pose orientation block, one entry per quaternion row
+        std::array<float, 4> poseOrientationTimestamps() const {
+            return readArray<float, 4>(offsetof(Block, poseOrientation) + ORIENTATION_QUATERNIONS * 4 * sizeof(float));
+        }
+
+        // the driver writes an identity orientation while it's (re)calibrating
+        bool poseResetState() const {
+            const Quaternion q = poseOrientation(0);
+            return q.x == 0.0f && q.y == 0.0f && q.z == 0.0f && q.w == 1.0f;
+        }
+
+    private:
+        template<typename T>
+        T read(size_t offset) const {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, m_data + offset, sizeof(T));
+            if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+                for (size_t i = 0; i < sizeof(T) / 2; ++i) std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+            }
+            T value;
+            std::memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
+
+        template<typename T, size_t N>
+        std::array<T, N> readArray(size_t offset) const {
+            std::array<T, N> values;
+            for (size_t i = 0; i < N; ++i) values[i] = read<T>(offset + i * sizeof(T));
+            return values;
+        }
+
+        Quaternion quaternionAt(size_t blockOffset, int row) const {
+            const auto v = readArray<float, 4>(blockOffset + row * 4 * sizeof(float));
+            return {v[0], v[1], v[2], v[3]};
+        }
+
+        const unsigned char *m_data;
+    };
+}
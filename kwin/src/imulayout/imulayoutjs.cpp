@@ -0,0 +1,33 @@
+// Writes the GNOME extension's copy of the layout, imulayout.js, from the FIELDS table in imulayout.h:
+//
+//   breezy_imu_layout_js path/to/imulayout.js
+
+#include "imulayout.h"
+
+#include <cstdio>
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output.js>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "// Generated from kwin/src/imulayout/imulayout.h by breezy_imu_layout_js, do not edit.\n");
+    fprintf(out, "// Rebuild the update_gnome_imu_layout target after changing the layout.\n\n");
+    fprintf(out, "// the driver should be using the same data layout version\n");
+    fprintf(out, "export const DATA_LAYOUT_VERSION = %u;\n\n", static_cast<unsigned>(ImuLayout::CURRENT_VERSION));
+    fprintf(out, "// DataView info: [offset, size, count]\n");
+    for (const ImuLayout::Field &field : ImuLayout::FIELDS) {
+        fprintf(out, "export const %s = [%zu, %zu, %zu];\n", field.name, field.offset, field.elementSize, field.count);
+    }
+    fprintf(out, "export const DATA_VIEW_LENGTH = %zu;\n", sizeof(ImuLayout::Block));
+
+    return fclose(out) == 0 ? 0 : 1;
+}
@@ -5,6 +5,8 @@
 #include "xrdriveripc.h"
 #include "customresolutiondialog.h"
 #include "virtualdisplayrow.h"
+#include "virtualdisplaylistmodel.h"
+#include "posereader.h"
 
 #include <kwineffects_interface.h>
 
@@ -27,11 +29,10 @@
 #include <QUrl>
 #include <QProcess>
 #include <QComboBox>
+#include <QRegularExpression>
 #include <QDBusInterface>
 #include <QDBusConnection>
 #include <QDBusReply>
-#include <QDBusVariant>
-#include <QDBusArgument>
 #include <QVariant>
 #include <QVariantList>
 #include <QHBoxLayout>
@@ -45,9 +46,12 @@
 #include <QVBoxLayout>
 #include <QFormLayout>
 #include <QSlider>
+#include <QAbstractSlider>
+#include <QAbstractButton>
 #include <QFile>
 #include <QDir>
 #include <QJsonDocument>
+#include <QDateTime>
 #include <QDebug>
 #include <QLocale>
 #include <QSignalBlocker>
@@ -65,6 +69,7 @@ namespace {
 constexpr int ROLE_SIZE = Qt::UserRole + 1;             // QVariant::fromValue(QSize)
 constexpr int ROLE_IS_CUSTOM = Qt::UserRole + 2;        // bool
 constexpr int ROLE_IS_ADD_CUSTOM = Qt::UserRole + 3;    // bool
+constexpr int ROLE_SCALE = Qt::UserRole + 4;            // double
 
 QString stateDirPath()
 {
@@ -110,27 +115,31 @@ void saveCustomResolutions(const QStringList &list)
     f.close();
 }
 
-bool parseResString(const QString &text, int &w, int &h)
+// "WxH", optionally followed by "<scale>%" as written by BreezyVirtualDisplays::modeLabel(). Entries saved by
+// older versions may also carry "@<rate>Hz", which still parses but is dropped.
+bool parseResString(const QString &text, BreezyVirtualDisplays::VirtualDisplayInfo &mode)
 {
-    const QString t = text.trimmed().toLower();
-    const QString xChar = QString::fromUtf8("x");
-    const QString multChar = QString::fromUtf8("×");
-    QString s = t;
-    s.replace(multChar, xChar);
-    const QStringList parts = s.split(QLatin1Char('x'), Qt::SkipEmptyParts);
-    if (parts.size() != 2) return false;
-    bool okW=false, okH=false;
-    int ww = parts[0].toInt(&okW);
-    int hh = parts[1].toInt(&okH);
-    if (!okW || !okH) return false;
+    static const QRegularExpression pattern(
+        QStringLiteral("^(\\d+)\\s*[x×]\\s*(\\d+)(?:\\s*@\\s*\\d+\\s*hz)?(?:\\s*(\\d+)\\s*%)?$"),
+        QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = pattern.match(text.trimmed());
+    if (!match.hasMatch()) return false;
+    const int ww = match.captured(1).toInt();
+    const int hh = match.captured(2).toInt();
+    const int scalePercent = match.captured(3).isEmpty() ? 100 : match.captured(3).toInt();
     if (ww < 320 || hh < 200) return false;
     if (ww > 32768 || hh > 32768) return false;
-    w = ww; h = hh; return true;
+    if (scalePercent < 100 || scalePercent > 300) return false;
+    mode.width = ww;
+    mode.height = hh;
+    mode.scale = scalePercent / 100.0;
+    return true;
 }
 
-void addResolutionItem(QComboBox *combo, QString label, QSize resolution, bool isCustom, bool isAddCustom) {
+void addResolutionItem(QComboBox *combo, QString label, QSize resolution, bool isCustom, bool isAddCustom, double scale = 1.0) {
     combo->addItem(label);
     combo->setItemData(combo->count()-1, QVariant::fromValue(resolution), ROLE_SIZE);
+    combo->setItemData(combo->count()-1, scale, ROLE_SCALE);
     combo->setItemData(combo->count()-1, isCustom, ROLE_IS_CUSTOM);
     combo->setItemData(combo->count()-1, isAddCustom, ROLE_IS_ADD_CUSTOM);
 }
@@ -144,10 +153,11 @@ void populateResolutionCombo(QComboBox *combo, const QStringList &custom)
     addResolutionItem(combo, QStringLiteral("1440p"), QSize(2560,1440), false, false);
 
     for (const QString &res : custom) {
-        int w=0,h=0;
-        if (!parseResString(res, w, h)) continue;
-        const QString label = QStringLiteral("%1x%2").arg(w).arg(h);
-        addResolutionItem(combo, label, QSize(w,h), true, false);
+        BreezyVirtualDisplays::VirtualDisplayInfo mode;
+        if (!parseResString(res, mode)) continue;
+        const QString label = BreezyVirtualDisplays::modeLabel(mode.width, mode.height, mode.scale);
+        if (combo->findText(label) >= 0) continue; // older entries that only differed by refresh rate
+        addResolutionItem(combo, label, QSize(mode.width, mode.height), true, false, mode.scale);
     }
 
     addResolutionItem(combo, QObject::tr("Add custom…"), QSize(), false, true);
@@ -175,13 +185,53 @@ QSize sizeForIndex(const QComboBox *combo, int index)
     return v.toSize();
 }
 
-bool showCustomResolutionDialog(QWidget *parent, int &outW, int &outH)
+double scaleForIndex(const QComboBox *combo, int index)
+{
+    if (!combo || index < 0 || index >= combo->count()) return 1.0;
+    const QVariant v = combo->itemData(index, ROLE_SCALE);
+    return v.isValid() ? v.toDouble() : 1.0;
+}
+
+// Setting bindings: each returns a function that applies the current config value to its widget, but only
+// touches the widget when the value differs, and with its signals blocked so it doesn't bounce back into save()
+std::function<void()> bindSetting(QAbstractSlider *slider, std::function<int()> configValue)
+{
+    return [slider, configValue]() {
+        const int value = configValue();
+        if (slider->value() == value) return;
+        const QSignalBlocker blocker(slider);
+        slider->setValue(value);
+    };
+}
+
+std::function<void()> bindSetting(QAbstractButton *button, std::function<bool()> configValue)
+{
+    return [button, configValue]() {
+        const bool value = configValue();
+        if (button->isChecked() == value) return;
+        const QSignalBlocker blocker(button);
+        button->setChecked(value);
+    };
+}
+
+std::function<void()> bindSetting(QComboBox *combo, std::function<int()> configValue)
+{
+    return [combo, configValue]() {
+        const int value = configValue();
+        if (combo->currentIndex() == value) return;
+        const QSignalBlocker blocker(combo);
+        combo->setCurrentIndex(value);
+    };
+}
+
+bool showCustomResolutionDialog(QWidget *parent, BreezyVirtualDisplays::VirtualDisplayInfo &outMode)
 {
     CustomResolutionDialog dlg(parent);
     const int res = dlg.exec();
     if (res == QDialog::Accepted) {
-        outW = dlg.widthValue();
-        outH = dlg.heightValue();
+        outMode.width = dlg.widthValue();
+        outMode.height = dlg.heightValue();
+        outMode.scale = dlg.scaleValue() / 100.0;
         return true;
     }
     return false;
@@ -259,6 +309,44 @@ BreezyDesktopEffectConfig::BreezyDesktopEffectConfig(QObject *parent, const KPlu
             chk->setVisible(true);
             chk->setEnabled(true);
         }
+        if (auto lbl = widget()->findChild<QLabel*>(QStringLiteral("labelVirtualDisplayLayout"))) {
+            lbl->setVisible(true);
+        }
+        if (auto row = widget()->findChild<QWidget*>(QStringLiteral("widgetVirtualDisplayLayout"))) {
+            row->setVisible(true);
+            row->setEnabled(true);
+        }
+        if (auto layoutCombo = widget()->findChild<QComboBox*>(QStringLiteral("comboVirtualDisplayLayout"))) {
+            if (auto btn = widget()->findChild<QPushButton*>(QStringLiteral("buttonSaveVirtualDisplayLayout"))) {
+                connect(btn, &QPushButton::clicked, this, [this, layoutCombo]() {
+                    const QString name = layoutCombo->currentText().trimmed();
+                    if (name.isEmpty()) return;
+                    dbusSaveVirtualDisplayLayout(name);
+                    refreshVirtualDisplayLayouts();
+                });
+            }
+            if (auto btn = widget()->findChild<QPushButton*>(QStringLiteral("buttonRestoreVirtualDisplayLayout"))) {
+                connect(btn, &QPushButton::clicked, this, [this, layoutCombo]() {
+                    const QString name = layoutCombo->currentText().trimmed();
+                    if (name.isEmpty()) return;
+                    renderVirtualDisplays(dbusRestoreVirtualDisplayLayout(name));
+                    refreshVirtualDisplayLayouts();
+                });
+            }
+            if (auto btn = widget()->findChild<QPushButton*>(QStringLiteral("buttonRemoveVirtualDisplayLayout"))) {
+                connect(btn, &QPushButton::clicked, this, [this, layoutCombo]() {
+                    dbusRemoveVirtualDisplayLayout(layoutCombo->currentText().trimmed());
+                    refreshVirtualDisplayLayouts();
+                });
+            }
+        }
+        if (auto lbl = widget()->findChild<QLabel*>(QStringLiteral("labelVirtualDisplayPoolCount"))) {
+            lbl->setVisible(true);
+        }
+        if (auto slider = widget()->findChild<QWidget*>(QStringLiteral("kcfg_VirtualDisplayPoolCount"))) {
+            slider->setVisible(true);
+            slider->setEnabled(true);
+        }
 
         // Initialize the resolution picker controls
         if (auto combo = widget()->findChild<QComboBox*>(QStringLiteral("comboAddVirtualDisplay"))) {
@@ -282,9 +370,9 @@ BreezyDesktopEffectConfig::BreezyDesktopEffectConfig(QObject *parent, const KPlu
                 const int idx = combo->currentIndex();
                 if (isAddCustomIndex(combo, idx)) {
                     const int oldIdx = combo->property("lastResIndex").toInt();
-                    int w = 1920, h = 1080;
-                    if (showCustomResolutionDialog(widget(), w, h)) {
-                        const QString label = QStringLiteral("%1x%2").arg(w).arg(h);
+                    BreezyVirtualDisplays::VirtualDisplayInfo mode;
+                    if (showCustomResolutionDialog(widget(), mode)) {
+                        const QString label = BreezyVirtualDisplays::modeLabel(mode.width, mode.height, mode.scale);
                         QStringList custom = loadCustomResolutions();
                         if (!custom.contains(label)) {
                             custom << label;
@@ -311,7 +399,11 @@ BreezyDesktopEffectConfig::BreezyDesktopEffectConfig(QObject *parent, const KPlu
                     if (!isCustomIndex(combo, idx)) return;
                     const QString label = combo->itemText(idx);
                     QStringList custom = loadCustomResolutions();
-                    custom.removeAll(label);
+                    // stored entries are compared by their current label, so older "@<rate>Hz" ones go too
+                    custom.removeIf([&label](const QString &res) {
+                        BreezyVirtualDisplays::VirtualDisplayInfo mode;
+                        return res == label || (parseResString(res, mode) && BreezyVirtualDisplays::modeLabel(mode.width, mode.height, mode.scale) == label);
+                    });
                     saveCustomResolutions(custom);
                     populateResolutionCombo(combo, custom);
                 });
@@ -323,8 +415,7 @@ BreezyDesktopEffectConfig::BreezyDesktopEffectConfig(QObject *parent, const KPlu
                     const int idx = combo->currentIndex();
                     const QSize sz = sizeForIndex(combo, idx);
                     if (sz.isValid()) {
-                        auto list = dbusAddVirtualDisplay(sz.width(), sz.height());
-                        renderVirtualDisplays(list);
+                        renderVirtualDisplays(dbusAddVirtualDisplay(sz.width(), sz.height(), scaleForIndex(combo, idx)));
                     }
                 });
             }
@@ -335,7 +426,14 @@ BreezyDesktopEffectConfig::BreezyDesktopEffectConfig(QObject *parent, const KPlu
     m_statePollTimer.setTimerType(Qt::CoarseTimer);
     connect(&m_statePollTimer, &QTimer::timeout, this, &BreezyDesktopEffectConfig::pollDriverState);
     m_statePollTimer.start();
+
+    // reads the shared memory pose directly, no driver IPC or DBus round trip per update
+    m_poseReader = std::make_unique<BreezyPose::PoseReader>();
+    m_posePreviewTimer.setInterval(100);
+    connect(&m_posePreviewTimer, &QTimer::timeout, this, &BreezyDesktopEffectConfig::updatePosePreview);
     
+    setupSettingBindings();
+
     m_configWatcher = KConfigWatcher::create(BreezyDesktopConfig::self()->sharedConfig());
     if (m_configWatcher) {
         connect(m_configWatcher.data(), &KConfigWatcher::configChanged, this,
@@ -375,9 +473,12 @@ BreezyDesktopEffectConfig::BreezyDesktopEffectConfig(QObject *parent, const KPlu
     connect(ui.kcfg_DisplayHorizontalOffset, &QSlider::valueChanged, this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_DisplayVerticalOffset, &QSlider::valueChanged, this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_LookAheadOverride, &QSlider::valueChanged, this, &BreezyDesktopEffectConfig::save);
+    connect(ui.kcfg_VirtualDisplayPoolCount, &QSlider::valueChanged, this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_DisplayWrappingScheme, qOverload<int>(&QComboBox::currentIndexChanged), this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_AntialiasingQuality, qOverload<int>(&QComboBox::currentIndexChanged), this, &BreezyDesktopEffectConfig::save);
+    connect(ui.kcfg_TextureFiltering, qOverload<int>(&QComboBox::currentIndexChanged), this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_MirrorPhysicalDisplays, &QCheckBox::toggled, this, &BreezyDesktopEffectConfig::save);
+    connect(ui.kcfg_DynamicRenderScale, &QCheckBox::toggled, this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_RemoveVirtualDisplaysOnDisable, &QCheckBox::toggled, this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_AllDisplaysFollowMode, &QCheckBox::toggled, this, &BreezyDesktopEffectConfig::save);
     connect(ui.kcfg_CurvedDisplay, &QCheckBox::toggled, this, &BreezyDesktopEffectConfig::save);
@@ -441,14 +542,20 @@ BreezyDesktopEffectConfig::BreezyDesktopEffectConfig(QObject *parent, const KPlu
 
     applyDistanceLabelFormatters();
 
+    BreezyVirtualDisplays::registerDBusTypes();
+    const bool virtualDisplaySignalOk = QDBusConnection::sessionBus().connect(
+        QStringLiteral("org.kde.KWin"),
+        QStringLiteral("/com/xronlinux/BreezyDesktop"),
+        QStringLiteral("com.xronlinux.BreezyDesktop"),
+        QStringLiteral("VirtualDisplaysChanged"),
+        this,
+        SLOT(renderVirtualDisplays(BreezyVirtualDisplays::VirtualDisplayInfoList)));
+    if (!virtualDisplaySignalOk) {
+        qCWarning(KWIN_XR) << "Failed to subscribe to VirtualDisplaysChanged";
+    }
+    connectVirtualDisplayView();
     renderVirtualDisplays(dbusListVirtualDisplays());
-
-    m_virtualDisplayPollTimer.setInterval(15000);
-    m_virtualDisplayPollTimer.setTimerType(Qt::CoarseTimer);
-    connect(&m_virtualDisplayPollTimer, &QTimer::timeout, this, [this]() {
-        renderVirtualDisplays(dbusListVirtualDisplays());
-    });
-    m_virtualDisplayPollTimer.start();
+    refreshVirtualDisplayLayouts();
 
     // General tab: Open KDE Displays Settings
     if (auto btnDisplays = widget()->findChild<QPushButton*>(QStringLiteral("buttonOpenDisplaysSettings"))) {
@@ -529,25 +636,38 @@ void BreezyDesktopEffectConfig::updateConfigFromUi()
     ui.shortcutsEditor->save();
 }
 
+void BreezyDesktopEffectConfig::setupSettingBindings()
+{
+    auto *config = BreezyDesktopConfig::self();
+    m_settingBindings = {
+        bindSetting(ui.kcfg_FocusedDisplayDistance, [config]() { return config->focusedDisplayDistance(); }),
+        bindSetting(ui.kcfg_AllDisplaysDistance, [config]() { return config->allDisplaysDistance(); }),
+        bindSetting(ui.kcfg_DisplaySize, [config]() { return config->displaySize(); }),
+        bindSetting(ui.kcfg_DisplaySpacing, [config]() { return config->displaySpacing(); }),
+        bindSetting(ui.kcfg_DisplayHorizontalOffset, [config]() { return config->displayHorizontalOffset(); }),
+        bindSetting(ui.kcfg_DisplayVerticalOffset, [config]() { return config->displayVerticalOffset(); }),
+        bindSetting(ui.kcfg_LookAheadOverride, [config]() { return config->lookAheadOverride(); }),
+        bindSetting(ui.kcfg_DisplayWrappingScheme, [config]() { return config->displayWrappingScheme(); }),
+        bindSetting(ui.kcfg_AntialiasingQuality, [config]() { return config->antialiasingQuality(); }),
+        bindSetting(ui.kcfg_TextureFiltering, [config]() { return config->textureFiltering(); }),
+        bindSetting(ui.kcfg_MirrorPhysicalDisplays, [config]() { return config->mirrorPhysicalDisplays(); }),
+        bindSetting(ui.kcfg_DynamicRenderScale, [config]() { return config->dynamicRenderScale(); }),
+        bindSetting(ui.kcfg_CurvedDisplay, [config]() { return config->curvedDisplay(); }),
+        bindSetting(ui.kcfg_RemoveVirtualDisplaysOnDisable, [config]() { return config->removeVirtualDisplaysOnDisable(); }),
+        bindSetting(ui.kcfg_VirtualDisplayPoolCount, [config]() { return config->virtualDisplayPoolCount(); }),
+        bindSetting(ui.kcfg_AllDisplaysFollowMode, [config]() { return config->allDisplaysFollowMode(); }),
+        bindSetting(ui.kcfg_ZoomOnFocusEnabled, [config]() { return config->zoomOnFocusEnabled(); }),
+        bindSetting(ui.kcfg_SmoothFollowThreshold, [config]() { return config->smoothFollowThreshold(); }),
+    };
+}
+
 void BreezyDesktopEffectConfig::updateUiFromConfig()
 {
-    ui.kcfg_FocusedDisplayDistance->setValue(BreezyDesktopConfig::self()->focusedDisplayDistance());
-    ui.kcfg_AllDisplaysDistance->setValue(BreezyDesktopConfig::self()->allDisplaysDistance());
-    ui.kcfg_DisplaySize->setValue(BreezyDesktopConfig::self()->displaySize());
-    ui.kcfg_DisplaySpacing->setValue(BreezyDesktopConfig::self()->displaySpacing());
-    ui.kcfg_DisplayHorizontalOffset->setValue(BreezyDesktopConfig::self()->displayHorizontalOffset());
-    ui.kcfg_DisplayVerticalOffset->setValue(BreezyDesktopConfig::self()->displayVerticalOffset());
-    ui.kcfg_LookAheadOverride->setValue(BreezyDesktopConfig::self()->lookAheadOverride());
-    ui.kcfg_DisplayWrappingScheme->setCurrentIndex(BreezyDesktopConfig::self()->displayWrappingScheme());
-    ui.kcfg_AntialiasingQuality->setCurrentIndex(BreezyDesktopConfig::self()->antialiasingQuality());
-    ui.kcfg_MirrorPhysicalDisplays->setChecked(BreezyDesktopConfig::self()->mirrorPhysicalDisplays());
-    ui.kcfg_CurvedDisplay->setChecked(BreezyDesktopConfig::self()->curvedDisplay());
-    ui.kcfg_RemoveVirtualDisplaysOnDisable->setChecked(BreezyDesktopConfig::self()->removeVirtualDisplaysOnDisable());
-    ui.kcfg_AllDisplaysFollowMode->setChecked(BreezyDesktopConfig::self()->allDisplaysFollowMode());
-    ui.kcfg_ZoomOnFocusEnabled->setChecked(BreezyDesktopConfig::self()->zoomOnFocusEnabled());
+    for (const auto &applyBinding : std::as_const(m_settingBindings)) {
+        applyBinding();
+    }
     ui.kcfg_FocusedDisplayDistance->setEnabled(
         ui.kcfg_ZoomOnFocusEnabled->isChecked() || ui.SmoothFollowEnabled->isChecked());
-    ui.kcfg_SmoothFollowThreshold->setValue(BreezyDesktopConfig::self()->smoothFollowThreshold());
 
     if (ui.comboMeasurementUnits) {
         QSignalBlocker b(ui.comboMeasurementUnits);
@@ -668,29 +788,70 @@ static QDBusInterface makeVDInterface() {
         QDBusConnection::sessionBus());
 }
 
-QVariantList BreezyDesktopEffectConfig::dbusListVirtualDisplays() const {
+BreezyVirtualDisplays::VirtualDisplayInfoList BreezyDesktopEffectConfig::dbusListVirtualDisplays() const {
+    QDBusInterface iface = makeVDInterface();
+    if (!iface.isValid()) return {};
+    QDBusReply<BreezyVirtualDisplays::VirtualDisplayInfoList> reply = iface.call(QStringLiteral("ListVirtualDisplays"));
+    return reply.isValid() ? reply.value() : BreezyVirtualDisplays::VirtualDisplayInfoList{};
+}
+
+BreezyVirtualDisplays::VirtualDisplayInfoList BreezyDesktopEffectConfig::dbusAddVirtualDisplay(int w, int h, double scale) const {
+    QDBusInterface iface = makeVDInterface();
+    if (!iface.isValid()) return {};
+    QDBusReply<BreezyVirtualDisplays::VirtualDisplayInfoList> reply = iface.call(QStringLiteral("AddVirtualDisplayWithMode"), w, h, scale);
+    return reply.isValid() ? reply.value() : BreezyVirtualDisplays::VirtualDisplayInfoList{};
+}
+
+BreezyVirtualDisplays::VirtualDisplayInfoList BreezyDesktopEffectConfig::dbusRemoveVirtualDisplay(const QString &id) const {
     QDBusInterface iface = makeVDInterface();
     if (!iface.isValid()) return {};
-    QDBusReply<QVariantList> reply = iface.call(QStringLiteral("ListVirtualDisplays"));
-    return reply.isValid() ? reply.value() : QVariantList{};
+    QDBusReply<BreezyVirtualDisplays::VirtualDisplayInfoList> reply = iface.call(QStringLiteral("RemoveVirtualDisplay"), id);
+    return reply.isValid() ? reply.value() : BreezyVirtualDisplays::VirtualDisplayInfoList{};
 }
 
-QVariantList BreezyDesktopEffectConfig::dbusAddVirtualDisplay(int w, int h) const {
+QStringList BreezyDesktopEffectConfig::dbusListVirtualDisplayLayouts() const {
     QDBusInterface iface = makeVDInterface();
     if (!iface.isValid()) return {};
-    // Fire add, then fetch authoritative list to avoid marshalling quirks
-    iface.call(QStringLiteral("AddVirtualDisplay"), w, h);
-    QDBusReply<QVariantList> list = iface.call(QStringLiteral("ListVirtualDisplays"));
-    return list.isValid() ? list.value() : QVariantList{};
+    QDBusReply<QStringList> reply = iface.call(QStringLiteral("ListVirtualDisplayLayouts"));
+    return reply.isValid() ? reply.value() : QStringList{};
 }
 
-QVariantList BreezyDesktopEffectConfig::dbusRemoveVirtualDisplay(const QString &id) const {
+QString BreezyDesktopEffectConfig::dbusActiveVirtualDisplayLayout() const {
     QDBusInterface iface = makeVDInterface();
     if (!iface.isValid()) return {};
-    // Fire remove, then fetch authoritative list to avoid marshalling quirks
-    iface.call(QStringLiteral("RemoveVirtualDisplay"), id);
-    QDBusReply<QVariantList> list = iface.call(QStringLiteral("ListVirtualDisplays"));
-    return list.isValid() ? list.value() : QVariantList{};
+    QDBusReply<QString> reply = iface.call(QStringLiteral("ActiveVirtualDisplayLayout"));
+    return reply.isValid() ? reply.value() : QString{};
+}
+
+bool BreezyDesktopEffectConfig::dbusSaveVirtualDisplayLayout(const QString &name) const {
+    QDBusInterface iface = makeVDInterface();
+    if (!iface.isValid()) return false;
+    QDBusReply<bool> reply = iface.call(QStringLiteral("SaveVirtualDisplayLayout"), name);
+    return reply.isValid() && reply.value();
+}
+
+BreezyVirtualDisplays::VirtualDisplayInfoList BreezyDesktopEffectConfig::dbusRestoreVirtualDisplayLayout(const QString &name) const {
+    QDBusInterface iface = makeVDInterface();
+    if (!iface.isValid()) return {};
+    QDBusReply<BreezyVirtualDisplays::VirtualDisplayInfoList> reply = iface.call(QStringLiteral("RestoreVirtualDisplayLayout"), name);
+    return reply.isValid() ? reply.value() : BreezyVirtualDisplays::VirtualDisplayInfoList{};
+}
+
+bool BreezyDesktopEffectConfig::dbusRemoveVirtualDisplayLayout(const QString &name) const {
+    QDBusInterface iface = makeVDInterface();
+    if (!iface.isValid()) return false;
+    QDBusReply<bool> reply = iface.call(QStringLiteral("RemoveVirtualDisplayLayout"), name);
+    return reply.isValid() && reply.value();
+}
+
+void BreezyDesktopEffectConfig::refreshVirtualDisplayLayouts() {
+    auto combo = widget()->findChild<QComboBox*>(QStringLiteral("comboVirtualDisplayLayout"));
+    if (!combo) return;
+
+    const QSignalBlocker blocker(combo);
+    combo->clear();
+    combo->addItems(dbusListVirtualDisplayLayouts());
+    combo->setCurrentText(dbusActiveVirtualDisplayLayout());
 }
 
 bool BreezyDesktopEffectConfig::dbusCurvedDisplaySupported() const {
@@ -700,70 +861,61 @@ bool BreezyDesktopEffectConfig::dbusCurvedDisplaySupported() const {
     return reply.isValid() && reply.value();
 }
 
-void BreezyDesktopEffectConfig::renderVirtualDisplays(const QVariantList &rows) {
+void BreezyDesktopEffectConfig::connectVirtualDisplayView() {
+    m_virtualDisplayModel = new VirtualDisplayListModel(this);
+
     auto listContainer = widget()->findChild<QWidget*>(QStringLiteral("widgetVirtualDisplayList"));
     auto listLayout = listContainer ? qobject_cast<QVBoxLayout*>(listContainer->layout()) : nullptr;
     if (!listContainer || !listLayout) return;
 
-    while (QLayoutItem *child = listLayout->takeAt(0)) {
-        if (auto w = child->widget()) w->deleteLater();
-        delete child;
-    }
-
-    const bool hasRows = !rows.isEmpty();
-    listContainer->setVisible(hasRows);
-    listContainer->setEnabled(hasRows);
-
-    auto toMapCompat = [](const QVariant &v) -> QVariantMap {
-        if (v.metaType().id() == QMetaType::QVariantMap) {
-            return v.toMap();
+    // one VirtualDisplayRow per model row, at the same position in the layout
+    auto updateVisibility = [this, listContainer]() {
+        const bool hasRows = m_virtualDisplayModel->rowCount() > 0;
+        listContainer->setVisible(hasRows);
+        listContainer->setEnabled(hasRows);
+    };
+    connect(m_virtualDisplayModel, &QAbstractItemModel::rowsInserted, this, [this, listContainer, listLayout, updateVisibility](const QModelIndex &, int first, int last) {
+        for (int row = first; row <= last; ++row) {
+            auto *rowWidget = new VirtualDisplayRow(listContainer);
+            rowWidget->setInfo(m_virtualDisplayModel->display(row));
+            connect(rowWidget, &VirtualDisplayRow::removeRequested, this, [this](const QString &vid) {
+                renderVirtualDisplays(dbusRemoveVirtualDisplay(vid));
+            });
+            listLayout->insertWidget(row, rowWidget);
         }
-        if (v.canConvert<QDBusVariant>()) {
-            const QDBusVariant dv = v.value<QDBusVariant>();
-            if (dv.variant().metaType().id() == QMetaType::QVariantMap) {
-                return dv.variant().toMap();
+        updateVisibility();
+    });
+    connect(m_virtualDisplayModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, [listLayout](const QModelIndex &, int first, int last) {
+        for (int row = last; row >= first; --row) {
+            if (QLayoutItem *child = listLayout->takeAt(row)) {
+                if (auto w = child->widget()) w->deleteLater();
+                delete child;
             }
         }
-        if (v.metaType().id() == qMetaTypeId<QDBusArgument>()) {
-            const QDBusArgument arg = v.value<QDBusArgument>();
-            QVariantMap map;
-            arg.beginMap();
-            while (!arg.atEnd()) {
-                arg.beginMapEntry();
-                QString key; QVariant val;
-                QDBusArgument &nonConst = const_cast<QDBusArgument&>(arg);
-                nonConst >> key >> val;
-                arg.endMapEntry();
-                map.insert(key, val);
-            }
-            arg.endMap();
-            return map;
+    });
+    connect(m_virtualDisplayModel, &QAbstractItemModel::rowsRemoved, this, updateVisibility);
+    connect(m_virtualDisplayModel, &QAbstractItemModel::rowsMoved, this, [listLayout](const QModelIndex &, int start, int, const QModelIndex &, int destination) {
+        if (QLayoutItem *child = listLayout->takeAt(start)) {
+            QWidget *w = child->widget();
+            delete child;
+            // destination is the row the item is moved in front of, counted before the move
+            if (w) listLayout->insertWidget(destination > start ? destination - 1 : destination, w);
         }
-        return QVariantMap{};
-    };
-
-    auto unwrapValue = [](QVariant v) -> QVariant {
-        if (v.canConvert<QDBusVariant>()) {
-            const QDBusVariant dv = v.value<QDBusVariant>();
-            return dv.variant();
+    });
+    connect(m_virtualDisplayModel, &QAbstractItemModel::dataChanged, this, [this, listLayout](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            QLayoutItem *item = listLayout->itemAt(row);
+            if (auto rowWidget = item ? qobject_cast<VirtualDisplayRow*>(item->widget()) : nullptr) {
+                rowWidget->setInfo(m_virtualDisplayModel->display(row));
+            }
         }
-        return v;
-    };
+    });
+    updateVisibility();
+}
 
-    for (const QVariant &rowVar : rows) {
-        const QVariantMap row = toMapCompat(rowVar);
-        const QString id = unwrapValue(row.value(QStringLiteral("id"))).toString();
-        const int w = unwrapValue(row.value(QStringLiteral("width"))).toInt();
-        const int h = unwrapValue(row.value(QStringLiteral("height"))).toInt();
-
-        auto *rowWidget = new VirtualDisplayRow(listContainer);
-        rowWidget->setInfo(id, w, h);
-        connect(rowWidget, &VirtualDisplayRow::removeRequested, this, [this](const QString &vid) {
-            auto list = dbusRemoveVirtualDisplay(vid);
-            renderVirtualDisplays(list);
-        });
-        listLayout->addWidget(rowWidget);
-    }
+void BreezyDesktopEffectConfig::renderVirtualDisplays(const BreezyVirtualDisplays::VirtualDisplayInfoList &rows) {
+    // the add/remove replies and the change signal usually carry the same list, which the model diffs away
+    if (m_virtualDisplayModel) m_virtualDisplayModel->setDisplays(rows);
 }
 
 void BreezyDesktopEffectConfig::updateDriverEnabled()
@@ -809,11 +961,17 @@ void BreezyDesktopEffectConfig::pollDriverState()
 
     m_connectedDeviceBrand = stateJson.value(QStringLiteral("connected_device_brand")).toString();
     m_connectedDeviceModel = stateJson.value(QStringLiteral("connected_device_model")).toString();
-    m_connectedDeviceFullDistanceCm = stateJson.value(QStringLiteral("connected_device_full_distance_cm")).toDouble(0.0);
-    m_connectedDeviceFullSizeCm = stateJson.value(QStringLiteral("connected_device_full_size_cm")).toDouble(0.0);
-    m_connectedDevicePoseHasPosition = stateJson.value(QStringLiteral("connected_device_pose_has_position")).toBool(false);
 
-    applyDistanceLabelFormatters();
+    // the distance label formatters only depend on these two, skip re-installing them when they're unchanged
+    const float fullDistanceCm = stateJson.value(QStringLiteral("connected_device_full_distance_cm")).toDouble(0.0);
+    const bool poseHasPosition = stateJson.value(QStringLiteral("connected_device_pose_has_position")).toBool(false);
+    const bool formattersChanged = !m_driverStateInitialized
+        || fullDistanceCm != m_connectedDeviceFullDistanceCm
+        || poseHasPosition != m_connectedDevicePoseHasPosition;
+    m_connectedDeviceFullDistanceCm = fullDistanceCm;
+    m_connectedDeviceFullSizeCm = stateJson.value(QStringLiteral("connected_device_full_size_cm")).toDouble(0.0);
+    m_connectedDevicePoseHasPosition = poseHasPosition;
+    if (formattersChanged) applyDistanceLabelFormatters();
 
     const bool smoothFollow = smoothFollowEnabled(stateJsonOpt);
     if (ui.SmoothFollowEnabled->isChecked() != smoothFollow) {
@@ -828,6 +986,14 @@ void BreezyDesktopEffectConfig::pollDriverState()
         ui.labelDeviceConnectionStatus->setText(m_deviceConnected ?
             QStringLiteral("%1 %2 connected").arg(m_connectedDeviceBrand, m_connectedDeviceModel) :
             QStringLiteral("No device connected"));
+
+        ui.labelPosePreview->setVisible(m_deviceConnected);
+        if (m_deviceConnected) {
+            m_posePreviewTimer.start();
+            updatePosePreview();
+        } else {
+            m_posePreviewTimer.stop();
+        }
     }
 
     if (m_deviceConnected) {
@@ -878,11 +1044,36 @@ void BreezyDesktopEffectConfig::pollDriverState()
         ui.DeadZoneThresholdDeg->setValue(dzInt);
     }
 
-    refreshLicenseUi(stateJson);
+    const QJsonObject licenseUiView = stateJson.value(QStringLiteral("ui_view")).toObject();
+    if (!m_driverStateInitialized || licenseUiView != m_lastLicenseUiView) {
+        m_lastLicenseUiView = licenseUiView;
+        refreshLicenseUi(stateJson);
+    }
 
     m_driverStateInitialized = true;
 }
 
+void BreezyDesktopEffectConfig::updatePosePreview()
+{
+    if (!widget()->isVisible()) return;
+
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const auto pose = m_poseReader->read(nowMs);
+    const qint64 ageMs = pose ? nowMs - static_cast<qint64>(pose->poseDateMs) : 0;
+    if (!pose || !pose->enabled || ageMs > 1000) {
+        ui.labelPosePreview->setText(i18n("Waiting for head tracking data…"));
+    } else if (pose->poseResetState) {
+        ui.labelPosePreview->setText(i18n("Calibrating, keep your head still…"));
+    } else {
+        // EUS euler angles: x is pitch, y is yaw, z is roll
+        const QVector3D euler = pose->orientation.toEulerAngles();
+        ui.labelPosePreview->setText(i18n("Yaw %1°  Pitch %2°  Roll %3°",
+                                          QString::number(euler.y(), 'f', 1),
+                                          QString::number(euler.x(), 'f', 1),
+                                          QString::number(euler.z(), 'f', 1)));
+    }
+}
+
 QString BreezyDesktopEffectConfig::measurementUnitsFromUi() const
 {
     if (!ui.comboMeasurementUnits) return QStringLiteral("cm");
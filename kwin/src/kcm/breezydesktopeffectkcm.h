@@ -2,18 +2,25 @@
 
 #include <KCModule>
 #include <KConfigWatcher>
+#include <functional>
 #include <memory>
+#include <optional>
 
+#include <QJsonObject>
 #include <QNetworkAccessManager>
 #include <QTimer>
 #include <QVariant>
 #include <QVariantList>
 #include <QString>
+#include <QStringList>
 
 #include "ui_breezydesktopeffectkcm.h"
+#include "virtualdisplayinfo.h"
 
 class KConfigWatcher;
+class VirtualDisplayListModel;
 class KConfigGroup;
+namespace BreezyPose { class PoseReader; }
 
 class BreezyDesktopEffectConfig : public KCModule
 {
@@ -28,6 +35,10 @@ public Q_SLOTS:
     void save() override;
     void defaults() override;
 
+private Q_SLOTS:
+    // connected by name to the effect's VirtualDisplaysChanged DBus signal
+    void renderVirtualDisplays(const BreezyVirtualDisplays::VirtualDisplayInfoList &rows);
+
 private:
     QString measurementUnitsFromUi() const;
     void applyDistanceLabelFormatters();
@@ -55,6 +66,7 @@ private:
     double neckSaverVerticalMultiplier(std::optional<QJsonObject> configJsonOpt);
     double deadZoneThresholdDeg(std::optional<QJsonObject> configJsonOpt);
     void pollDriverState();
+    void updatePosePreview();
     void refreshLicenseUi(const QJsonObject &rootObj);
     void checkEffectLoaded();
     void checkForUpdates();
@@ -63,10 +75,17 @@ private:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
     // Virtual display DBus helpers and UI rendering
-    QVariantList dbusListVirtualDisplays() const;
-    QVariantList dbusAddVirtualDisplay(int w, int h) const;
-    QVariantList dbusRemoveVirtualDisplay(const QString &id) const;
-    void renderVirtualDisplays(const QVariantList &rows);
+    BreezyVirtualDisplays::VirtualDisplayInfoList dbusListVirtualDisplays() const;
+    BreezyVirtualDisplays::VirtualDisplayInfoList dbusAddVirtualDisplay(int w, int h, double scale) const;
+    BreezyVirtualDisplays::VirtualDisplayInfoList dbusRemoveVirtualDisplay(const QString &id) const;
+    QStringList dbusListVirtualDisplayLayouts() const;
+    QString dbusActiveVirtualDisplayLayout() const;
+    bool dbusSaveVirtualDisplayLayout(const QString &name) const;
+    BreezyVirtualDisplays::VirtualDisplayInfoList dbusRestoreVirtualDisplayLayout(const QString &name) const;
+    bool dbusRemoveVirtualDisplayLayout(const QString &name) const;
+    void refreshVirtualDisplayLayouts();
+    void connectVirtualDisplayView();
+    void setupSettingBindings();
 
     bool dbusCurvedDisplaySupported() const;
 
@@ -85,7 +104,11 @@ private:
     float m_connectedDeviceFullSizeCm = 0.0;
     bool m_connectedDevicePoseHasPosition = false;
     QTimer m_statePollTimer; // periodic driver state polling
-    QTimer m_virtualDisplayPollTimer; // periodic virtual display list polling
+    QTimer m_posePreviewTimer; // live orientation readout, only runs while a device is connected
+    std::unique_ptr<BreezyPose::PoseReader> m_poseReader;
+    VirtualDisplayListModel *m_virtualDisplayModel = nullptr; // rows of widgetVirtualDisplayList follow this model
+    QList<std::function<void()>> m_settingBindings; // each applies one config value to its widget, only if it differs
+    QJsonObject m_lastLicenseUiView; // driver's ui_view last rendered by refreshLicenseUi
     bool m_licenseLoading = false;
     bool m_curvedDisplaySupported = true;
 };
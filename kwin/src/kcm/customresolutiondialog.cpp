@@ -18,3 +18,7 @@ int CustomResolutionDialog::widthValue() const {
 int CustomResolutionDialog::heightValue() const {
     return ui->sliderHeight->value();
 }
+
+int CustomResolutionDialog::scaleValue() const {
+    return ui->sliderScale->value();
+}
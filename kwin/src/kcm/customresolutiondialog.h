@@ -12,6 +12,7 @@ public:
 
     int widthValue() const;
     int heightValue() const;
+    int scaleValue() const; // percent
 
 private:
     Ui::CustomResolutionDialog *ui;
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+
+// Shared between the effect and the KCM: the typed DBus payload for virtual displays, signature a(siid)
+namespace BreezyVirtualDisplays {
+    struct VirtualDisplayInfo {
+        QString id;
+        int width = 0;
+        int height = 0;
+        double scale = 1.0;
+
+        bool operator==(const VirtualDisplayInfo &other) const = default;
+    };
+
+    using VirtualDisplayInfoList = QList<VirtualDisplayInfo>;
+
+    // "1920x1080", with " 150%" appended when the scale isn't 100%
+    inline QString modeLabel(int width, int height, double scale)
+    {
+        QString label = QStringLiteral("%1x%2").arg(width).arg(height);
+        if (qRound(scale * 100) != 100) label += QStringLiteral(" %1%").arg(qRound(scale * 100));
+        return label;
+    }
+
+    inline QDBusArgument &operator<<(QDBusArgument &argument, const VirtualDisplayInfo &info)
+    {
+        argument.beginStructure();
+        argument << info.id << info.width << info.height << info.scale;
+        argument.endStructure();
+        return argument;
+    }
+
+    inline const QDBusArgument &operator>>(const QDBusArgument &argument, VirtualDisplayInfo &info)
+    {
+        argument.beginStructure();
+        argument >> info.id >> info.width >> info.height >> info.scale;
+        argument.endStructure();
+        return argument;
+    }
+
+    // must run before the types are marshalled, on both ends of the connection
+    inline void registerDBusTypes()
+    {
+        qDBusRegisterMetaType<VirtualDisplayInfo>();
+        qDBusRegisterMetaType<VirtualDisplayInfoList>();
+    }
+}
+
+Q_DECLARE_METATYPE(BreezyVirtualDisplays::VirtualDisplayInfo)
@@ -0,0 +1,89 @@
+#include "virtualdisplaylistmodel.h"
+
+#include <algorithm>
+
+VirtualDisplayListModel::VirtualDisplayListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int VirtualDisplayListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : m_displays.size();
+}
+
+QVariant VirtualDisplayListModel::data(const QModelIndex &index, int role) const {
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) return {};
+
+    const auto &info = m_displays.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return BreezyVirtualDisplays::modeLabel(info.width, info.height, info.scale);
+    case IdRole:
+        return info.id;
+    case WidthRole:
+        return info.width;
+    case HeightRole:
+        return info.height;
+    case ScaleRole:
+        return info.scale;
+    }
+    return {};
+}
+
+QHash<int, QByteArray> VirtualDisplayListModel::roleNames() const {
+    return {
+        {Qt::DisplayRole, "display"},
+        {IdRole, "id"},
+        {WidthRole, "width"},
+        {HeightRole, "height"},
+        {ScaleRole, "scale"},
+    };
+}
+
+const BreezyVirtualDisplays::VirtualDisplayInfo &VirtualDisplayListModel::display(int row) const {
+    return m_displays.at(row);
+}
+
+int VirtualDisplayListModel::rowOf(const QString &id) const {
+    for (int row = 0; row < m_displays.size(); ++row) {
+        if (m_displays.at(row).id == id) return row;
+    }
+    return -1;
+}
+
+void VirtualDisplayListModel::setDisplays(const BreezyVirtualDisplays::VirtualDisplayInfoList &displays) {
+    // removals first, back to front so the remaining row numbers stay valid
+    for (int row = m_displays.size() - 1; row >= 0; --row) {
+        const QString &id = m_displays.at(row).id;
+        const bool kept = std::any_of(displays.cbegin(), displays.cend(), [&id](const auto &info) {
+            return info.id == id;
+        });
+        if (!kept) {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_displays.removeAt(row);
+            endRemoveRows();
+        }
+    }
+
+    // then walk the new list in order: move, update or insert each entry into its target row
+    for (int target = 0; target < displays.size(); ++target) {
+        const auto &info = displays.at(target);
+        const int current = rowOf(info.id);
+        if (current == -1) {
+            beginInsertRows(QModelIndex(), target, target);
+            m_displays.insert(target, info);
+            endInsertRows();
+            continue;
+        }
+        if (current != target) {
+            beginMoveRows(QModelIndex(), current, current, QModelIndex(), target);
+            m_displays.move(current, target);
+            endMoveRows();
+        }
+        if (!(m_displays.at(target) == info)) {
+            m_displays[target] = info;
+            const QModelIndex changed = index(target);
+            Q_EMIT dataChanged(changed, changed);
+        }
+    }
+}
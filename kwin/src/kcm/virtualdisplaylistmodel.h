@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QAbstractListModel>
+
+#include "virtualdisplayinfo.h"
+
+// The effect's virtual displays, keyed by id. setDisplays() diffs against the current rows and only
+// emits inserts, removals and dataChanged for what actually differs, so views can update row by row.
+class VirtualDisplayListModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        WidthRole,
+        HeightRole,
+        ScaleRole,
+    };
+
+    explicit VirtualDisplayListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    const BreezyVirtualDisplays::VirtualDisplayInfo &display(int row) const;
+    void setDisplays(const BreezyVirtualDisplays::VirtualDisplayInfoList &displays);
+
+private:
+    int rowOf(const QString &id) const;
+
+    BreezyVirtualDisplays::VirtualDisplayInfoList m_displays;
+};
@@ -20,8 +20,8 @@ VirtualDisplayRow::~VirtualDisplayRow() {
     delete ui;
 }
 
-void VirtualDisplayRow::setInfo(const QString &id, int w, int h) {
-    m_id = id;
-    ui->labelId->setText(id);
-    ui->labelRes->setText(QStringLiteral("%1x%2").arg(w).arg(h));
+void VirtualDisplayRow::setInfo(const BreezyVirtualDisplays::VirtualDisplayInfo &info) {
+    m_id = info.id;
+    ui->labelId->setText(info.id);
+    ui->labelRes->setText(BreezyVirtualDisplays::modeLabel(info.width, info.height, info.scale));
 }
@@ -2,6 +2,8 @@
 
 #include <QWidget>
 
+#include "virtualdisplayinfo.h"
+
 namespace Ui { class VirtualDisplayRow; }
 
 class VirtualDisplayRow : public QWidget {
@@ -10,7 +12,7 @@ public:
     explicit VirtualDisplayRow(QWidget *parent = nullptr);
     ~VirtualDisplayRow() override;
 
-    void setInfo(const QString &id, int w, int h);
+    void setInfo(const BreezyVirtualDisplays::VirtualDisplayInfo &info);
 
 Q_SIGNALS:
     void removeRequested(const QString &id);
@@ -0,0 +1,158 @@
+#include "motiontophoton.h"
+
+#include "core/renderloop.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace KWin
+{
+
+MotionToPhotonMeter::MotionToPhotonMeter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+MotionToPhotonMeter::~MotionToPhotonMeter()
+{
+    detach();
+}
+
+void MotionToPhotonMeter::attach(RenderLoop *renderLoop)
+{
+    if (m_renderLoop.data() == renderLoop) return;
+    detach();
+    if (!renderLoop) return;
+
+    m_renderLoop = renderLoop;
+    m_presentedConnection = connect(renderLoop, &RenderLoop::framePresented, this,
+                                    [this](RenderLoop *, std::chrono::nanoseconds timestamp) {
+        framePresented(timestamp.count());
+    });
+}
+
+void MotionToPhotonMeter::detach()
+{
+    disconnect(m_presentedConnection);
+    m_renderLoop.clear();
+    m_pending.clear();
+}
+
+void MotionToPhotonMeter::stampFrame(std::chrono::milliseconds presentTime, quint64 poseTimestampMs, qreal targetTimestampMs)
+{
+    if (!m_renderLoop) {
+        // without feedback the previous frame is done by now, and its prediction is all there is to go on
+        while (!m_pending.isEmpty()) {
+            const Frame frame = m_pending.takeFirst();
+            record(frame, frame.predictedPresentNs, false);
+        }
+    } else if (m_pending.size() >= MaxPendingFrames) {
+        // frames the compositor dropped never get feedback
+        m_pending.removeFirst();
+        ++m_framesUnmatched;
+    }
+
+    Frame frame;
+    frame.sequence = m_sequence++;
+    frame.predictedPresentNs = std::chrono::duration_cast<std::chrono::nanoseconds>(presentTime).count();
+    frame.poseTimestampMs = poseTimestampMs;
+    frame.targetTimestampMs = targetTimestampMs;
+    m_pending.append(frame);
+}
+
+void MotionToPhotonMeter::framePresented(qint64 presentNs)
+{
+    if (m_pending.isEmpty()) return;
+    record(m_pending.takeFirst(), presentNs, true);
+}
+
+void MotionToPhotonMeter::record(Frame frame, qint64 presentNs, bool fromFeedback)
+{
+    // presentation times are on the monotonic clock, pose timestamps on the wall clock
+    const qint64 nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    frame.fromFeedback = fromFeedback;
+    frame.presentTimestampMs = QDateTime::currentMSecsSinceEpoch() + (presentNs - nowNs) / 1e6;
+    frame.poseAgeAtPresentMs = frame.presentTimestampMs - frame.poseTimestampMs;
+    m_poseAgeAtPresentMs.add(frame.poseAgeAtPresentMs);
+
+    // for a predicted frame the error is just the look-ahead constant and the lateness is zero by construction
+    if (fromFeedback) {
+        frame.predictionErrorMs = frame.presentTimestampMs - frame.targetTimestampMs;
+        frame.presentLateMs = (presentNs - frame.predictedPresentNs) / 1e6;
+        m_predictionErrorMs.add(frame.predictionErrorMs);
+        m_presentLateMs.add(frame.presentLateMs);
+        ++m_histogram[std::clamp(static_cast<int>(frame.poseAgeAtPresentMs), 0, HistogramBuckets - 1)];
+        ++m_framesFromFeedback;
+    }
+
+    m_recent.append(frame);
+    if (m_recent.size() > RecentFrames) m_recent.removeFirst();
+}
+
+QVariantMap MotionToPhotonMeter::summary() const
+{
+    QVariantList histogram;
+    histogram.reserve(HistogramBuckets);
+    for (quint64 count : m_histogram) histogram.append(static_cast<qulonglong>(count));
+
+    QVariantMap summary{
+        {QStringLiteral("presentSource"), m_renderLoop ? QStringLiteral("feedback") : QStringLiteral("predicted")},
+        {QStringLiteral("framesMeasured"), static_cast<qulonglong>(m_poseAgeAtPresentMs.total())},
+        {QStringLiteral("framesUnmatched"), static_cast<qulonglong>(m_framesUnmatched)},
+        {QStringLiteral("framesFromFeedback"), static_cast<qulonglong>(m_framesFromFeedback)},
+        {QStringLiteral("poseAgeAtPresentMs"), m_poseAgeAtPresentMs.summary()}
+    };
+
+    // left out rather than null until a frame got feedback: the map goes out over DBus, which has no null
+    if (m_framesFromFeedback > 0) {
+        summary.insert(QStringLiteral("predictionErrorMs"), m_predictionErrorMs.summary());
+        summary.insert(QStringLiteral("presentLateMs"), m_presentLateMs.summary());
+        summary.insert(QStringLiteral("histogramBucketMs"), 1);
+        summary.insert(QStringLiteral("poseAgeAtPresentHistogram"), histogram);
+    }
+    return summary;
+}
+
+void MotionToPhotonMeter::reset()
+{
+    m_recent.clear();
+    m_histogram.fill(0);
+    m_framesUnmatched = 0;
+    m_framesFromFeedback = 0;
+    m_poseAgeAtPresentMs.clear();
+    m_predictionErrorMs.clear();
+    m_presentLateMs.clear();
+}
+
+bool MotionToPhotonMeter::writeCsv(const QString &path) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    file.write("sequence,present_source,present_timestamp_ms,pose_timestamp_ms,look_ahead_ms,pose_age_at_present_ms,"
+               "prediction_error_ms,present_late_ms\n");
+    for (const Frame &frame : m_recent) {
+        // predicted frames leave the columns that only feedback can fill empty
+        const auto measured = [&frame](qreal value) {
+            return frame.fromFeedback ? QString::number(value, 'f', 3) : QString();
+        };
+        file.write(QStringLiteral("%1,%2,%3,%4,%5,%6,%7,%8\n")
+                       .arg(frame.sequence)
+                       .arg(frame.fromFeedback ? QStringLiteral("feedback") : QStringLiteral("predicted"))
+                       .arg(frame.presentTimestampMs, 0, 'f', 3)
+                       .arg(frame.poseTimestampMs)
+                       .arg(frame.targetTimestampMs - frame.poseTimestampMs, 0, 'f', 3)
+                       .arg(frame.poseAgeAtPresentMs, 0, 'f', 3)
+                       .arg(measured(frame.predictionErrorMs))
+                       .arg(measured(frame.presentLateMs))
+                       .toUtf8());
+    }
+    return file.commit();
+}
+
+}
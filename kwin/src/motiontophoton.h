@@ -0,0 +1,81 @@
+#pragma once
+
+#include "rollingsamples.h"
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QVariantMap>
+
+#include <array>
+#include <chrono>
+
+namespace KWin
+{
+
+class RenderLoop;
+
+// Motion-to-photon latency: how old the pose an effect frame was rendered with is by the time that frame reaches
+// the screen, and how far off the look-ahead's target time was.
+//
+// Each frame is stamped when its camera is placed and matched, in order, with the render loop's presentation
+// feedback for the output. Where the render loop isn't reachable, a frame's predicted presentation time stands in
+// for the actual one and is reported as such. The prediction error, the lateness and the age histogram would only
+// restate the prediction for those frames, so they're only collected, and only reported, for frames with feedback.
+class MotionToPhotonMeter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MotionToPhotonMeter(QObject *parent = nullptr);
+    ~MotionToPhotonMeter() override;
+
+    void attach(RenderLoop *renderLoop);
+    void detach();
+
+    // presentTime is the compositor's prediction on the monotonic clock; the pose and target timestamps are wall
+    // clock ms, targetTimestampMs being the pose timestamp plus the look-ahead it was predicted forward by
+    void stampFrame(std::chrono::milliseconds presentTime, quint64 poseTimestampMs, qreal targetTimestampMs);
+
+    QVariantMap summary() const;
+    void reset();
+
+    // one row per recently presented frame, oldest first
+    bool writeCsv(const QString &path) const;
+
+private:
+    struct Frame {
+        quint64 sequence = 0;
+        qint64 predictedPresentNs = 0;
+        quint64 poseTimestampMs = 0;
+        qreal targetTimestampMs = 0.0;
+        bool fromFeedback = false;
+        qreal presentTimestampMs = 0.0;
+        qreal poseAgeAtPresentMs = 0.0;
+        qreal predictionErrorMs = 0.0;
+        qreal presentLateMs = 0.0;
+    };
+
+    void framePresented(qint64 presentNs);
+    void record(Frame frame, qint64 presentNs, bool fromFeedback);
+
+    // 1 ms wide, the last one also collects everything older
+    static constexpr int HistogramBuckets = 100;
+    static constexpr int MaxPendingFrames = 8;
+    static constexpr int RecentFrames = 3600;
+
+    QPointer<RenderLoop> m_renderLoop;
+    QMetaObject::Connection m_presentedConnection;
+    QList<Frame> m_pending;
+    QList<Frame> m_recent;
+    std::array<quint64, HistogramBuckets> m_histogram{};
+    quint64 m_sequence = 0;
+    quint64 m_framesUnmatched = 0;
+    quint64 m_framesFromFeedback = 0;
+
+    RollingSamples m_poseAgeAtPresentMs{600};
+    RollingSamples m_predictionErrorMs{600};
+    RollingSamples m_presentLateMs{600};
+};
+
+}
@@ -0,0 +1,106 @@
+#include "posereader.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace BreezyPose
+{
+
+PoseStatus classifyBlock(const ImuLayout::View &block, qint64 nowMs) {
+    if (!block.parityMatches()) return PoseStatus::Torn;
+    if (!block.isCurrentVersion()) return PoseStatus::WrongVersion;
+    if (!block.enabled() || block.displayFov() == 0.0f) return PoseStatus::Disabled;
+    if (!isKeepAliveValid(block.poseDateMs(), nowMs)) return PoseStatus::Stale;
+    if (block.poseResetState()) return PoseStatus::Reset;
+    return PoseStatus::Tracking;
+}
+
+PoseSnapshot decodePose(const ImuLayout::View &block, qint64 nowMs) {
+    PoseSnapshot pose;
+    pose.status = classifyBlock(block, nowMs);
+    pose.version = block.version();
+    pose.enabled = block.enabled();
+    pose.poseDateMs = block.poseDateMs();
+    pose.lookAheadConfig = block.lookAheadConfig();
+
+    const auto displayResolution = block.displayResolution();
+    pose.displayResolution = QSize(displayResolution[0], displayResolution[1]);
+    pose.diagonalFov = block.displayFov();
+    pose.lensDistanceRatio = block.lensDistanceRatio();
+    pose.sbsEnabled = block.sbsEnabled();
+    pose.customBannerEnabled = block.customBannerEnabled();
+    pose.smoothFollowEnabled = block.smoothFollowEnabled();
+    pose.smoothFollowOrigin = toEus(block.smoothFollowOrigin(0));
+    pose.previousSmoothFollowOrigin = toEus(block.smoothFollowOrigin(1));
+
+    pose.position = toEus(block.posePosition());
+
+    // the oldest row isn't needed: two samples are enough for the rate of change the look-ahead extrapolates with
+    pose.poseResetState = block.poseResetState();
+    pose.orientation = toEus(block.poseOrientation(0));
+    pose.previousOrientation = toEus(block.poseOrientation(1));
+    const auto timestamps = block.poseOrientationTimestamps();
+    pose.orientationTimestampMs = timestamps[0];
+    pose.previousOrientationTimestampMs = timestamps[1];
+
+    return pose;
+}
+
+PoseReader::PoseReader(const QString &path)
+    : m_path(path.toLocal8Bit())
+{
+}
+
+PoseReader::~PoseReader() {
+    close();
+}
+
+void PoseReader::close() {
+    if (m_fd != -1) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_inode = 0;
+}
+
+bool PoseReader::reopen() {
+    close();
+    m_fd = ::open(m_path.constData(), O_RDONLY | O_CLOEXEC);
+    if (m_fd == -1) return false;
+
+    struct stat fileStat;
+    if (::fstat(m_fd, &fileStat) != 0) {
+        close();
+        return false;
+    }
+    m_inode = fileStat.st_ino;
+    return true;
+}
+
+std::optional<PoseSnapshot> PoseReader::read(qint64 nowMs) {
+    // the file may be deleted and recreated, e.g. when the driver restarts, and an open descriptor would keep
+    // reading the old one forever
+    struct stat pathStat;
+    if (::stat(m_path.constData(), &pathStat) != 0) {
+        close();
+        return std::nullopt;
+    }
+    if (pathStat.st_size != sizeof(ImuLayout::Block)) return std::nullopt;
+    if ((m_fd == -1 || static_cast<quint64>(pathStat.st_ino) != m_inode) && !reopen()) return std::nullopt;
+
+    char buffer[sizeof(ImuLayout::Block)];
+    if (::pread(m_fd, buffer, sizeof(buffer), 0) != static_cast<ssize_t>(sizeof(buffer))) return std::nullopt;
+
+    const ImuLayout::View block(buffer, sizeof(buffer));
+    if (!block.isValid()) return std::nullopt;
+
+    const PoseSnapshot pose = decodePose(block, nowMs);
+    if (pose.status == PoseStatus::Torn) {
+        ++m_tornReads;
+        return std::nullopt;
+    }
+    return pose;
+}
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QByteArray>
+#include <QQuaternion>
+#include <QSize>
+#include <QString>
+#include <QVector3D>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "imulayout.h"
+
+// Qt side of the driver's shared memory pose block, shared by the effect and the KCM; the layout itself is in imulayout.h
+namespace BreezyPose
+{
+    inline const QString SHM_DIR = QStringLiteral("/dev/shm");
+    inline const QString SHM_PATH = QString::fromLatin1(ImuLayout::SHM_PATH);
+
+    // the block stores NWU, the scene works in EUS
+    inline QQuaternion toEus(const ImuLayout::Quaternion &nwu) {
+        const ImuLayout::Quaternion eus = ImuLayout::nwuToEus(nwu);
+        return QQuaternion(eus.w, eus.x, eus.y, eus.z);
+    }
+
+    inline QVector3D toEus(const ImuLayout::Vector3 &nwu) {
+        const ImuLayout::Vector3 eus = ImuLayout::nwuToEus(nwu);
+        return QVector3D(eus.x, eus.y, eus.z);
+    }
+
+    // consumers treat the driver as gone once the pose hasn't been updated for this long
+    constexpr qint64 KEEP_ALIVE_MS = 5000;
+
+    inline bool isKeepAliveValid(quint64 poseDateMs, qint64 nowMs) {
+        return nowMs - static_cast<qint64>(poseDateMs) < KEEP_ALIVE_MS;
+    }
+
+    // How a consumer treats a block, checked in this order. Only Reset and Tracking mean the driver wants the effect
+    // running; Torn blocks are dropped before they're decoded.
+    enum class PoseStatus {
+        Torn, // caught mid-write, the parity byte doesn't match the data
+        WrongVersion, // written by a driver with a different block layout
+        Disabled, // the driver has the effect turned off, or no glasses are connected and the FOV is zero
+        Stale, // the keep-alive lapsed, the driver stopped writing
+        Reset, // identity orientation, written while the driver is (re)calibrating
+        Tracking,
+    };
+
+    PoseStatus classifyBlock(const ImuLayout::View &block, qint64 nowMs);
+
+    inline bool isActive(PoseStatus status) {
+        return status == PoseStatus::Reset || status == PoseStatus::Tracking;
+    }
+
+    // One decoded pose file, with the orientations and position already converted from the driver's NWU to EUS
+    struct PoseSnapshot {
+        PoseStatus status = PoseStatus::Disabled;
+        uint8_t version = 0;
+        bool enabled = false;
+        quint64 poseDateMs = 0;
+        std::array<float, 4> lookAheadConfig{};
+
+        // the two newest orientation rows and their sample times, which are on the driver's clock, not the wall clock
+        QQuaternion orientation;
+        QQuaternion previousOrientation;
+        float orientationTimestampMs = 0.0f;
+        float previousOrientationTimestampMs = 0.0f;
+        QVector3D position;
+        bool poseResetState = false; // identity orientation, written while the driver is (re)calibrating
+
+        QSize displayResolution;
+        float diagonalFov = 0.0f;
+        float lensDistanceRatio = 0.0f;
+        bool sbsEnabled = false;
+        bool customBannerEnabled = false;
+        bool smoothFollowEnabled = false;
+        QQuaternion smoothFollowOrigin;
+        QQuaternion previousSmoothFollowOrigin;
+    };
+
+    // nowMs is the wall clock the keep-alive is judged against
+    PoseSnapshot decodePose(const ImuLayout::View &block, qint64 nowMs);
+
+    // Reads the pose file through a descriptor that's kept open between reads and only reopened when the driver
+    // recreates the file, so polling it costs a stat and a pread rather than an open, read and close. pread
+    // rather than mmap: a mapping would fault with SIGBUS if the driver truncated the file mid-read.
+    // Not thread safe; each consumer owns its own reader.
+    class PoseReader
+    {
+    public:
+        explicit PoseReader(const QString &path = SHM_PATH);
+        ~PoseReader();
+
+        PoseReader(const PoseReader &) = delete;
+        PoseReader &operator=(const PoseReader &) = delete;
+
+        // nullopt when the file is missing, has the wrong size, or was caught mid-write
+        std::optional<PoseSnapshot> read(qint64 nowMs);
+
+        // reads that were dropped because the driver was caught mid-write
+        quint64 tornReads() const { return m_tornReads; }
+
+    private:
+        bool reopen();
+        void close();
+
+        QByteArray m_path;
+        int m_fd = -1;
+        quint64 m_inode = 0;
+        quint64 m_tornReads = 0;
+    };
+}
@@ -4,7 +4,8 @@ import QtQuick3D
 
 Node {
     id: breezyDesktop
-    
+
+    required property BreezyDesktopEffect effect
     property var viewportResolution: effect.displayResolution
     property bool smoothFollowEnabled: effect.smoothFollowEnabled
     required property var screens
@@ -13,10 +14,11 @@ Node {
     required property var monitorPlacements
     property int focusedMonitorIndex: -1
     property int lookingAtMonitorIndex: -1
-    property var smoothFollowFocusedDisplay
+    property BreezyDesktopDisplay smoothFollowFocusedDisplay: null
 
     Displays {
         id: displays
+        effect: breezyDesktop.effect
     }
 
     function displayAtIndex(index) {
@@ -44,6 +46,7 @@ Node {
             if (breezyDesktop.lookingAtMonitorIndex !== lookingAtIndex) {
                 breezyDesktop.lookingAtMonitorIndex = lookingAtIndex;
                 effect.lookingAtScreenIndex = lookingAtIndex;
+                effect.lookingAtScreenName = lookingAtIndex !== -1 ? breezyDesktop.screens[lookingAtIndex].name : "";
             }
 
             if (effect.zoomOnFocusEnabled || smoothFollowEnabled) {
@@ -113,10 +116,9 @@ Node {
         }
     }
 
-    function displayRotationVector(display) {
+    function displayRotationVector(display: BreezyDesktopDisplay): vector3d {
         const displayNwu = 
-            display.monitorPlacement.centerNoRotate
-                                    .times(display.monitorDistance / effect.allDisplaysDistance);
+            display.placementCenter.times(display.monitorDistance / effect.allDisplaysDistance);
 
         const eusVector = displays.nwuToEusVector(displayNwu)
         return display.rotationMatrix.times(eusVector);
@@ -125,14 +127,14 @@ Node {
     // smoothFollowOrigin is the rotation away from the original placement of the displays
     // poseOrientations is the smooth follow rotation relative to the camera (very near an identity quat)
     // subtract the latter from the former to get the complete rotation
-    function smoothFollowQuat() {
+    function smoothFollowQuat(): quaternion {
         return effect.smoothFollowOrigin[0].times(effect.poseOrientations[0].conjugated());
     }
 
-    function displaySmoothFollowVector(display, smoothFollowRotation) {
+    function displaySmoothFollowVector(display: BreezyDesktopDisplay, smoothFollowRotation: quaternion): vector3d {
         // for smooth follow, place the display centered directly in front of the camera
         const displayDistanceNorth = 
-            display.monitorPlacement.monitorCenterNorth * 
+            display.placementCenterNorth * 
             display.monitorDistance / effect.allDisplaysDistance;
         const eusVector = Qt.vector3d(0, 0, -displayDistanceNorth);
 
@@ -141,7 +143,7 @@ Node {
 
     // don't call this from the delegate to avoid binding the position property to the effect properties 
     // used for smooth follow
-    function displayPosition(display, smoothFollowRotation) {
+    function displayPosition(display: BreezyDesktopDisplay, smoothFollowRotation: quaternion): vector3d {
         // short circuit to avoid slerping if not needed
         if (display.smoothFollowTransitionProgress === 1.0) {
             return displaySmoothFollowVector(display, smoothFollowRotation);
@@ -164,13 +166,11 @@ Node {
             sizeAdjustedScreen: breezyDesktop.sizeAdjustedScreens[index]
             monitorPlacement: breezyDesktop.monitorPlacements[index]
             fovDetails: breezyDesktop.fovDetails
-            
-            property real smoothFollowTransitionProgress: 0.0
-            property real monitorDistance: effect.allDisplaysDistance
-            property real targetDistance: effect.allDisplaysDistance
+            effect: breezyDesktop.effect
+
             property real screenRotationY: displays.radianToDegree(monitorPlacement?.rotationAngleRadians.y ?? 0)
             property real screenRotationX: displays.radianToDegree(monitorPlacement?.rotationAngleRadians.x ?? 0)
-            property matrix4x4 rotationMatrix: {
+            rotationMatrix: {
                 const matrix = Qt.matrix4x4();
                 matrix.rotate(screenRotationY, Qt.vector3d(0, 1, 0));
                 matrix.rotate(screenRotationX, Qt.vector3d(1, 0, 0));
@@ -210,7 +210,7 @@ Node {
         running: false
         onTriggered: {
             if (!breezyDesktop.smoothFollowFocusedDisplay && breezyDesktop.focusedMonitorIndex !== -1) {
-                breezyDesktop.smoothFollowFocusedDisplay = breezyDesktopDisplays.objectAt(breezyDesktop.focusedMonitorIndex)
+                breezyDesktop.smoothFollowFocusedDisplay = breezyDesktopDisplays.objectAt(breezyDesktop.focusedMonitorIndex) as BreezyDesktopDisplay;
             }
 
             let continueRunning = false;
@@ -9,13 +9,25 @@ Model {
     required property var monitorPlacement
     required property int index
     required property var fovDetails
+    required property BreezyDesktopEffect effect
+
+    // placement state that BreezyDesktop.qml drives; declared here so its per-frame functions take a typed display
+    property real smoothFollowTransitionProgress: 0.0
+    property real monitorDistance: effect.allDisplaysDistance
+    property real targetDistance: effect.allDisplaysDistance
+    property matrix4x4 rotationMatrix
+    readonly property vector3d placementCenter: monitorPlacement?.centerNoRotate ?? Qt.vector3d(0, 0, 0)
+    readonly property real placementCenterNorth: monitorPlacement?.monitorCenterNorth ?? 0
 
     property string cursorImageSource: effect.cursorImageSource
     property size cursorImageSize: effect.cursorImageSize
     property point cursorPos: effect.cursorPos
+    property bool peripheral: effect.lookingAtScreenName !== "" && effect.lookingAtScreenName !== screen.name
+    property real textureScale: peripheral ? effect.peripheralTextureScale : 1.0
 
     Displays {
         id: displays
+        effect: display.effect
     }
 
     // Default to simple rectangle source so we work on older Qt6
@@ -34,17 +46,26 @@ Model {
                 if (mesh) {
                     display.source = "";
                     display.geometry = mesh;
-                    effect.curvedDisplaySupported = true;
+                    display.effect.curvedDisplaySupported = true;
                 }
             } else {
                 console.error("Breezy - CurvableDisplayMesh not available:", component.errorString());
-                effect.curvedDisplaySupported = false;
+                display.effect.curvedDisplaySupported = false;
             }
         } catch (e) {
             console.error("Breezy - CurvableDisplayMesh loading error:", e);
-            effect.curvedDisplaySupported = false;
+            display.effect.curvedDisplaySupported = false;
+        }
+    }
+    Connections {
+        target: display.effect
+        function onDisplayTexturesDamaged(screenNames) {
+            if (screenNames.indexOf(display.screen.name) !== -1) {
+                desktopSource.scheduleUpdate();
+            }
         }
     }
+
     materials: [
         CustomMaterial {
             id: customMat
@@ -58,22 +79,45 @@ Model {
             property real cursorW: display.cursorImageSize.width
             property real cursorH: display.cursorImageSize.height
             property bool showCursor: cursorX >= 0 && cursorX < screenWidth && cursorY >= 0 && cursorY < screenHeight
+            property bool filteredSampling: display.effect.antialiasingQuality === 6
+            property bool anisotropicSampling: display.effect.textureFiltering === 2
 
+            // Captured on demand rather than live: the effect reports which screens were damaged once per
+            // frame, so untouched displays keep reusing their last texture instead of re-rendering every frame.
+            // The mip chain is built as part of each capture, so it's only regenerated for damaged displays.
             property TextureInput desktopTex: TextureInput {
                 texture: Texture {
-                    sourceItem: DesktopView {
-                        screen: display.screen
+                    mipFilter: display.effect.textureFiltering > 0 ? Texture.Linear : Texture.None
+                    sourceItem: ShaderEffectSource {
+                        id: desktopSource
                         width: display.screen.geometry.width
                         height: display.screen.geometry.height
+                        sourceItem: desktopView
+                        hideSource: true
+                        live: false
+                        mipmap: display.effect.textureFiltering > 0
+
+                        // an empty size captures at the item's size
+                        textureSize: display.textureScale < 1.0
+                            ? Qt.size(Math.round(width * display.textureScale), Math.round(height * display.textureScale))
+                            : Qt.size(0, 0)
+                        smooth: true
+
+                        DesktopView {
+                            id: desktopView
+                            screen: display.screen
+                            width: display.screen.geometry.width
+                            height: display.screen.geometry.height
+                        }
                     }
                 }
             }
             property TextureInput cursorTex: TextureInput {
                 texture: Texture {
                     sourceItem: Image {
-                        source: effect.cursorImageSource
-                        width: effect.cursorImageSize.width
-                        height: effect.cursorImageSize.height
+                        source: display.cursorImageSource
+                        width: display.cursorImageSize.width
+                        height: display.cursorImageSize.height
                     }
                 }
             }
@@ -4,11 +4,14 @@ import QtQuick3D
 Item {
     id: cameraController
 
-    required property Camera camera
+    required property BreezyDesktopEffect effect
+    required property CustomCamera camera
+    property CustomCamera rightEyeCamera: null
     required property var fovDetails
 
     Displays {
         id: displays
+        effect: cameraController.effect
     }
 
     property real aspectRatio: effect.displayResolution[0] / effect.displayResolution[1]
@@ -24,6 +27,18 @@ Item {
     property real fovHalfVerticalTangent: fovLengths.heightUnitDistance / 2.0;
     property real fovHalfHorizontalTangent: fovLengths.widthUnitDistance / 2.0;
 
+    // the lens distance is measured from the neck pivot, which sits roughly 10cm behind the eyes;
+    // an average IPD of 63mm relative to that puts the eyes this far apart in scene units
+    property real eyeSeparationPixels: lensDistancePixels * 0.63
+
+    // fovDetails is a plain JS object, so the per-frame functions read these typed copies of its fields instead
+    readonly property real lensDistancePixels: fovDetails.lensDistancePixels
+    readonly property real fullScreenDistancePixels: fovDetails.fullScreenDistancePixels
+
+    // Qt.vector3d() returns an untyped value, so the vectors the per-frame functions rotate are built here
+    readonly property vector3d lensOffset: Qt.vector3d(0, 0, -lensDistancePixels)
+    readonly property vector3d halfEyeSeparation: Qt.vector3d(eyeSeparationPixels / 2.0, 0, 0)
+
     // if true, then smoothFollowEnabled just cleared and the orientation data is slerping back, 
     // continue to use the origin data for the duration of the Timer
     property bool smoothFollowDisabling: false
@@ -31,67 +46,48 @@ Item {
     property real clipNear: 10.0
     property real clipFar: 10000.0
 
-    function ratesOfChange(orientations) {
-        const e0 = orientations[0].toEulerAngles();
-        const e1 = orientations[1].toEulerAngles();
-        const dt = effect.poseTimeElapsedMs;
-        const yawDegrees = (e0.y - e1.y) / dt;
-        const pitchDegrees = (e0.x - e1.x) / dt;
-        const rollDegrees = (e0.z - e1.z) / dt;
-
-        return {
-            eulerEnd: e0,
-            eulerStart: e1,
-            yawDegrees: yawDegrees,
-            yaw: displays.degreeToRadian(yawDegrees),
-            pitchDegrees: pitchDegrees,
-            pitch: displays.degreeToRadian(pitchDegrees),
-            rollDegrees: rollDegrees,
-            roll: displays.degreeToRadian(rollDegrees)
-        };
+    // degrees per ms between the two latest orientations, as euler angles: x pitch, y yaw, z roll
+    function ratesOfChange(latest: quaternion, previous: quaternion, elapsedMs: real): vector3d {
+        return latest.toEulerAngles().minus(previous.toEulerAngles()).times(1.0 / elapsedMs);
     }
 
-    function updateCamera(orientations, position, rates) {
-        camera.eulerRotation = applyLookAhead(
-            rates,
-            lookAheadMS(
-                effect.poseTimestamp,
-                effect.lookAheadConfig,
-                effect.lookAheadOverride
-            )
-        );
-        let lensVector = Qt.vector3d(0, 0, -fovDetails.lensDistancePixels);
-
+    // orientation is the latest pose, rotation the one predicted for the frame's presentation
+    function updateCamera(orientation: quaternion, rotation: quaternion, position: vector3d): void {
         // if we only have 3DoF, account for a bit of positional change based on orientation,
         // don't do this for 6DoF to prevent doubling the positional movement due to rotation
-        if (!effect.poseHasPosition) lensVector = orientations[0].times(lensVector);
-
-        camera.position = position.times(fovDetails.fullScreenDistancePixels).plus(lensVector);
+        const lensVector = effect.poseHasPosition ? lensOffset : orientation.times(lensOffset);
+        const centerPosition = lensVector.plus(position.times(fullScreenDistancePixels));
+
+        camera.rotation = rotation;
+        if (sbsEnabled && rightEyeCamera) {
+            // both eyes share the head pose, offset half the eye separation along the camera's right axis
+            camera.position = centerPosition.minus(rotation.times(halfEyeSeparation));
+            rightEyeCamera.rotation = rotation;
+            rightEyeCamera.position = centerPosition.plus(rotation.times(halfEyeSeparation));
+        } else {
+            camera.position = centerPosition;
+        }
     }
 
-    // how far to look ahead is how old the pose data is plus a constant that is either the default for this device or an override
-    function lookAheadMS(poseDateMs, lookAheadConfig, override) {
-        // how stale the pose data is
-        const dataAge = Date.now() - poseDateMs;
-
-        const lookAheadConstant = lookAheadConfig[0];
-        const lookAheadMultiplier = lookAheadConfig[1];
+    // how far to look ahead is how old the pose data will be when the frame is presented plus a constant that is
+    // either the default for this device or an override
+    function lookAheadMS(poseDateMs: real, lookAheadConstant: real, override: real): real {
+        // how stale the pose data will be at the compositor's predicted presentation time, which the effect sets
+        // before every framePrepared
+        const dataAge = effect.predictedPresentTimestamp - poseDateMs;
         return (override === -1 ? lookAheadConstant : override) + dataAge;
     }
 
-    function applyLookAhead(rates, lookAheadMs) {
-        return Qt.vector3d(
-            rates.eulerEnd.x + rates.pitchDegrees * lookAheadMs,
-            rates.eulerEnd.y + rates.yawDegrees * lookAheadMs,
-            rates.eulerEnd.z + rates.rollDegrees * lookAheadMs,
-        );
+    function applyLookAhead(eulerEnd: vector3d, rates: vector3d, lookAheadMs: real): vector3d {
+        return eulerEnd.plus(rates.times(lookAheadMs));
     }
 
-    function updateProjection() {
+    function updateProjection(): void {
         camera.projection = buildPerspectiveMatrix();
+        if (rightEyeCamera) rightEyeCamera.projection = camera.projection;
     }
 
-    function buildPerspectiveMatrix() {
+    function buildPerspectiveMatrix(): matrix4x4 {
         const f = 1.0 / fovHalfVerticalTangent;
         const nf = 1.0 / (clipNear - clipFar);
         const m00 = f / aspectRatio;
@@ -108,10 +104,12 @@ Item {
         );
     }
 
-    function applyRollingShutterShear(rates) {
+    function applyRollingShutterShear(rates: vector3d): void {
         // Convert to maximum shift at bottom of frame
-        const maxDxNdc = (rates.yaw * lookAheadScanlineMs) / fovHalfHorizontalTangent;
-        const maxDyNdc = -(rates.pitch * lookAheadScanlineMs) / fovHalfVerticalTangent;
+        const yawRate = rates.y;
+        const pitchRate = rates.x;
+        const maxDxNdc = (displays.degreeToRadian(yawRate) * lookAheadScanlineMs) / fovHalfHorizontalTangent;
+        const maxDyNdc = -(displays.degreeToRadian(pitchRate) * lookAheadScanlineMs) / fovHalfVerticalTangent;
 
         let shx = maxDxNdc / 2.0;
         let shy = maxDyNdc / 2.0;
@@ -149,19 +147,28 @@ Item {
             r2c0, r2c1, r2c2, r2c3,
             r3c0, r3c1, r3c2, r3c3
         );
+        if (sbsEnabled && rightEyeCamera) rightEyeCamera.projection = camera.projection;
+    }
+
+    function placeCameras(): void {
+        const orientations = (effect.smoothFollowEnabled || smoothFollowDisabling) ? effect.smoothFollowOrigin : effect.poseOrientations;
+        if (orientations.length < 2) return;
+
+        const latest = orientations[0];
+        const rates = ratesOfChange(latest, orientations[1], effect.poseTimeElapsedMs);
+        const lookAheadMs = lookAheadMS(effect.poseTimestamp, effect.lookAheadConfig[0], effect.lookAheadOverride);
+        const predicted = applyLookAhead(latest.toEulerAngles(), rates, lookAheadMs);
+        updateCamera(latest, Quaternion.fromEulerAngles(predicted), effect.posePosition);
+        applyRollingShutterShear(rates);
     }
 
     Component.onCompleted: updateProjection();
 
-    FrameAnimation {
-        running: true
-        onTriggered: {
-            const orientations = (effect.smoothFollowEnabled || smoothFollowDisabling) ? effect.smoothFollowOrigin : effect.poseOrientations;
-            if (orientations && orientations.length > 0) {
-                const rates = ratesOfChange(orientations);
-                updateCamera(orientations, effect.posePosition, rates);
-                applyRollingShutterShear(rates);
-            }
+    // driven by the compositor's frames so the camera is placed for the frame that's about to be painted
+    Connections {
+        target: cameraController.effect
+        function onFramePrepared() {
+            cameraController.placeCameras();
         }
     }
 
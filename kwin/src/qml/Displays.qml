@@ -1,29 +1,31 @@
 import QtQuick
 
 QtObject {
+    required property BreezyDesktopEffect effect
+
     readonly property real focusThreshold: 0.95 / 2.0
     readonly property real unfocusThreshold: 1.1 / 2.0
 
     // Converts degrees to radians
-    function degreeToRadian(degree) {
+    function degreeToRadian(degree: real): real {
         return degree * Math.PI / 180;
     }
 
-    function radianToDegree(radian) {
+    function radianToDegree(radian: real): real {
         return radian * 180 / Math.PI;
     }
 
-    function nwuToEusVector(vector) {
+    function nwuToEusVector(vector: vector3d): vector3d {
         // Converts NWU vector to EUS vector
         return Qt.vector3d(-vector.y, vector.z, -vector.x);
     }
 
-    function eusToNwuVector(vector) {
+    function eusToNwuVector(vector: vector3d): vector3d {
         // Converts EUS vector to NWU vector
         return Qt.vector3d(-vector.z, -vector.x, vector.y);
     }
 
-    function eusToNwuQuat(quaternion) {
+    function eusToNwuQuat(quaternion: quaternion): quaternion {
         // Converts EUS quaternion to NWU quaternion
         return Qt.quaternion(quaternion.scalar, -quaternion.z, -quaternion.x, quaternion.y);
     }
@@ -464,7 +466,7 @@ QtObject {
         return -1;
     }
 
-    function slerpVector(from, to, progress) {
+    function slerpVector(from: vector3d, to: vector3d, progress: real): vector3d {
         const inverseProgress = 1.0 - progress;
         const finalVector = Qt.vector3d(
             from.x * inverseProgress + to.x * progress,
@@ -2,19 +2,21 @@ import QtQuick
 
 Item {
     id: singleDesktopView
+    required property BreezyDesktopEffect effect
+    required property var targetScreen
     property bool supportsXR: false
     property bool showCalibratingBanner: false
 
     DesktopView {
         id: desktopViewComponent
-        screen: targetScreen
-        width: targetScreen.geometry.width
-        height: targetScreen.geometry.height
+        screen: singleDesktopView.targetScreen
+        width: singleDesktopView.targetScreen.geometry.width
+        height: singleDesktopView.targetScreen.geometry.height
     }
 
     Image {
-        source: effect.customBannerEnabled ? "custom_banner.png" : "calibrating.png"
-        visible: supportsXR && showCalibratingBanner
+        source: singleDesktopView.effect.customBannerEnabled ? "custom_banner.png" : "calibrating.png"
+        visible: singleDesktopView.supportsXR && singleDesktopView.showCalibratingBanner
         anchors.horizontalCenter: desktopViewComponent.horizontalCenter
         anchors.bottom: desktopViewComponent.bottom
     }
@@ -1,9 +1,52 @@
 VARYING vec3 pos;
 VARYING vec2 texcoord;
 
+// Supersample only the display surface: four rotated-grid taps spread over this pixel's footprint in
+// the desktop texture. Text stays sharp when a texel maps to a pixel, and edges get filtered when the
+// display is minified or viewed at an angle, without rendering the whole scene at a higher resolution.
+vec4 filteredDesktopSample(vec2 tex) {
+    vec2 dx = dFdx(tex);
+    vec2 dy = dFdy(tex);
+    vec4 color = textureGrad(desktopTex, tex + 0.125 * dx + 0.375 * dy, dx, dy);
+    color += textureGrad(desktopTex, tex - 0.125 * dx - 0.375 * dy, dx, dy);
+    color += textureGrad(desktopTex, tex + 0.375 * dx - 0.125 * dy, dx, dy);
+    color += textureGrad(desktopTex, tex - 0.375 * dx + 0.125 * dy, dx, dy);
+    return color * 0.25;
+}
+
+// Quick3D textures don't expose the sampler's anisotropy, so approximate it: sample along the long axis of
+// this pixel's footprint, using the short axis' gradient to pick a sharper mip level.
+const int MAX_ANISOTROPIC_TAPS = 8;
+vec4 anisotropicDesktopSample(vec2 tex) {
+    vec2 dx = dFdx(tex);
+    vec2 dy = dFdy(tex);
+    vec2 texSize = vec2(screenWidth, screenHeight);
+    float lengthX = length(dx * texSize);
+    float lengthY = length(dy * texSize);
+    vec2 majorAxis = lengthX > lengthY ? dx : dy;
+    vec2 minorAxis = lengthX > lengthY ? dy : dx;
+    float ratio = max(lengthX, lengthY) / max(min(lengthX, lengthY), 1e-6);
+    int taps = int(clamp(ceil(ratio), 1.0, float(MAX_ANISOTROPIC_TAPS)));
+
+    vec4 color = vec4(0.0);
+    for (int i = 0; i < MAX_ANISOTROPIC_TAPS; i++) {
+        if (i >= taps) break;
+        vec2 offset = majorAxis * ((float(i) + 0.5) / float(taps) - 0.5);
+        color += textureGrad(desktopTex, tex + offset, minorAxis, minorAxis);
+    }
+    return color / float(taps);
+}
+
 void MAIN() {
     vec2 tex = vec2(texcoord.x, 1.0 - texcoord.y);
-    vec4 color = texture(desktopTex, tex);
+    vec4 color;
+    if (anisotropicSampling) {
+        color = anisotropicDesktopSample(tex);
+    } else if (filteredSampling) {
+        color = filteredDesktopSample(tex);
+    } else {
+        color = texture(desktopTex, tex);
+    }
     if (showCursor) {
         vec2 fragCoord = tex * vec2(screenWidth, screenHeight);
         vec2 cursorTopLeft = vec2(cursorX, cursorY);
@@ -1,7 +1,6 @@
 import QtQuick
 import QtQuick3D
 import org.kde.kwin as KWinComponents
-import org.kde.kwin.effect.breezy_desktop
 
 Item {
     id: root
@@ -28,16 +27,32 @@ Item {
         "Rokid Max 2",
         "Rokid Air"
     ]
-    required property QtObject effect
+    required property BreezyDesktopEffect effect
     required property QtObject targetScreen
 
     property real viewportDiagonalFOVDegrees: effect.diagonalFOV
     property var viewportResolution: effect.displayResolution
     property bool mirrorPhysicalDisplays: effect.mirrorPhysicalDisplays
     property bool developerMode: effect.developerMode
-    property var screens: KWinComponents.Workspace.screens.filter(function(screen) {
-        return developerMode || mirrorPhysicalDisplays || screen.name.includes("BreezyDesktop") || supportedModels.some(model => screen.model.includes(model));
-    })
+
+    // Not bound directly to Workspace.screens: adding several virtual displays changes the screen list once per
+    // output, and every change rebuilds the display delegates and recomputes the layout. Qt.callLater coalesces
+    // the changes that arrive in the same event loop pass into a single update.
+    property var screens: []
+    function updateScreens() {
+        screens = KWinComponents.Workspace.screens.filter(function(screen) {
+            return developerMode || mirrorPhysicalDisplays || screen.name.includes("BreezyDesktop") || supportedModels.some(model => screen.model.includes(model));
+        });
+    }
+    Connections {
+        target: KWinComponents.Workspace
+        function onScreensChanged() {
+            Qt.callLater(root.updateScreens);
+        }
+    }
+    onDeveloperModeChanged: Qt.callLater(updateScreens)
+    onMirrorPhysicalDisplaysChanged: Qt.callLater(updateScreens)
+
     property real distanceAdjustedSize: (effect.allDisplaysDistance - effect.lensDistanceRatio) * effect.displaySize
     property var sizeAdjustedScreens: screens.map(function(screen) {
         const sizeComplement = (1.0 - distanceAdjustedSize) / 2.0;
@@ -91,6 +106,7 @@ Item {
 
     Displays {
         id: displays
+        effect: root.effect
     }
 
     property var fovDetails: displays.buildFovDetails(
@@ -127,6 +143,8 @@ Item {
     Component {
         id: desktopViewComponent
         SingleDesktopView {
+            effect: root.effect
+            targetScreen: root.targetScreen
             supportsXR: targetScreenSupported
             showCalibratingBanner: isEnabled && poseResetState
         }
@@ -134,33 +152,143 @@ Item {
 
     Component {
         id: view3DComponent
-        View3D {
-            anchors.fill: parent
-            environment: SceneEnvironment {
-                antialiasingMode: root.effect.antialiasingQuality === 0 ? SceneEnvironment.NoAA : SceneEnvironment.SSAA
-                antialiasingQuality: root.effect.antialiasingQuality === 0 ? SceneEnvironment.Medium : (
-                    root.effect.antialiasingQuality === 1 ? SceneEnvironment.Medium : (
-                    root.effect.antialiasingQuality === 2 ? SceneEnvironment.High : SceneEnvironment.VeryHigh))
+        Item {
+            id: view3DRoot
+
+            // in SBS mode each eye gets half of the output
+            property bool sbsEnabled: root.effect.sbsEnabled
+            property real eyeWidth: sbsEnabled ? width / 2 : width
+
+            // The scene lives outside of the views and is imported by both eyes, so the display nodes, their
+            // materials and desktop textures exist once and are only rendered again from the second camera.
+            Node {
+                id: sharedScene
+
+                CustomCamera {
+                    id: camera
+                }
+
+                CustomCamera {
+                    id: rightEyeCamera
+                }
+
+                BreezyDesktop {
+                    id: breezyDesktop
+                    effect: root.effect
+                    screens: root.screens
+                    sizeAdjustedScreens: root.sizeAdjustedScreens
+                    fovDetails: root.fovDetails
+                    monitorPlacements: root.monitorPlacements
+                }
             }
-            
-            CustomCamera { 
-                id: camera
+
+            // 1-3 supersample the whole scene; 4 and 5 are cheaper whole-scene modes; 6 leaves the scene
+            // aliased and lets the display material filter its own texture fetches (see cursorOverlay.frag)
+            SceneEnvironment {
+                id: sceneEnvironment
+                antialiasingMode: {
+                    switch (root.effect.antialiasingQuality) {
+                    case 1:
+                    case 2:
+                    case 3:
+                        return SceneEnvironment.SSAA;
+                    case 4:
+                        return SceneEnvironment.MSAA;
+                    default:
+                        return SceneEnvironment.NoAA;
+                    }
+                }
+                antialiasingQuality: {
+                    switch (root.effect.antialiasingQuality) {
+                    case 2:
+                        return SceneEnvironment.High;
+                    case 3:
+                        return SceneEnvironment.VeryHigh;
+                    case 4:
+                        return SceneEnvironment.High;
+                    default:
+                        return SceneEnvironment.Medium;
+                    }
+                }
+                temporalAAEnabled: root.effect.antialiasingQuality === 5
             }
 
-            BreezyDesktop {
-                id: breezyDesktop
-                screens: root.screens
-                sizeAdjustedScreens: root.sizeAdjustedScreens
-                fovDetails: root.fovDetails
-                monitorPlacements: root.monitorPlacements
+            View3D {
+                id: leftEyeView
+
+                // render at the governor's scale and let the item transform stretch it back over the output
+                width: view3DRoot.eyeWidth * root.effect.renderScale
+                height: view3DRoot.height * root.effect.renderScale
+                transformOrigin: Item.TopLeft
+                scale: 1.0 / root.effect.renderScale
+                smooth: true
+
+                environment: sceneEnvironment
+                importScene: sharedScene
+                camera: camera
+            }
+
+            View3D {
+                id: rightEyeView
+                visible: view3DRoot.sbsEnabled
+
+                x: view3DRoot.eyeWidth
+                width: view3DRoot.eyeWidth * root.effect.renderScale
+                height: view3DRoot.height * root.effect.renderScale
+                transformOrigin: Item.TopLeft
+                scale: 1.0 / root.effect.renderScale
+                smooth: true
+
+                environment: sceneEnvironment
+                importScene: sharedScene
+                camera: rightEyeCamera
             }
 
             CameraController {
                 id: cameraController
+                effect: root.effect
                 anchors.fill: parent
                 camera: camera
+                rightEyeCamera: rightEyeCamera
                 fovDetails: root.fovDetails
             }
+
+            Text {
+                id: renderStatsOverlay
+                visible: root.developerMode
+                anchors.left: parent.left
+                anchors.top: parent.top
+                anchors.margins: 20
+                color: "lime"
+                font.family: "monospace"
+                font.pixelSize: 14
+
+                function msLine(label, samples) {
+                    return `${label}: p50 ${samples.p50.toFixed(2)} p90 ${samples.p90.toFixed(2)} p99 ${samples.p99.toFixed(2)} ms`;
+                }
+
+                Timer {
+                    running: renderStatsOverlay.visible
+                    repeat: true
+                    interval: 1000
+                    triggeredOnStart: true
+                    onTriggered: {
+                        const stats = root.effect.renderStats();
+                        const gpu = stats.gpuPasses;
+                        const lines = [
+                            `frames ${stats.framesRendered} missed ${stats.missedFrames} scale ${stats.renderScale.toFixed(2)}`
+                        ];
+                        if (gpu.supported) {
+                            lines.push(renderStatsOverlay.msLine("gpu offscreen", gpu.offscreenMs));
+                            lines.push(renderStatsOverlay.msLine("gpu main pass", gpu.mainPassMs));
+                            lines.push(renderStatsOverlay.msLine("gpu total", gpu.totalMs));
+                        } else {
+                            lines.push("gpu timer queries unsupported");
+                        }
+                        renderStatsOverlay.text = lines.join("\n");
+                    }
+                }
+            }
         }
     }
 
@@ -189,6 +317,7 @@ Item {
     }
     
     Component.onCompleted: {
+        updateScreens();
         checkLoadedComponent();
     }
 }
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QVariantMap>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Fixed-size window of the most recent samples, summarized for the diagnostics exposed over DBus.
+class RollingSamples
+{
+public:
+    explicit RollingSamples(int capacity = 240)
+        : m_capacity(std::max(capacity, 1))
+    {
+        m_samples.reserve(m_capacity);
+    }
+
+    void add(double sample)
+    {
+        if (static_cast<int>(m_samples.size()) < m_capacity) {
+            m_samples.push_back(sample);
+        } else {
+            m_samples[m_next] = sample;
+        }
+        m_next = (m_next + 1) % m_capacity;
+        m_last = sample;
+        ++m_total;
+    }
+
+    void clear()
+    {
+        m_samples.clear();
+        m_next = 0;
+        m_last = 0.0;
+        m_total = 0;
+    }
+
+    bool isEmpty() const { return m_samples.empty(); }
+    int count() const { return static_cast<int>(m_samples.size()); }
+    quint64 total() const { return m_total; }
+    double last() const { return m_last; }
+
+    double mean() const
+    {
+        if (m_samples.empty()) return 0.0;
+        double sum = 0.0;
+        for (double s : m_samples) sum += s;
+        return sum / m_samples.size();
+    }
+
+    // p in [0, 1], nearest-rank on a copy so the ring order is preserved
+    double percentile(double p) const
+    {
+        if (m_samples.empty()) return 0.0;
+        std::vector<double> sorted = m_samples;
+        const size_t rank = static_cast<size_t>(std::ceil(std::clamp(p, 0.0, 1.0) * sorted.size()));
+        const size_t index = rank == 0 ? 0 : rank - 1;
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    }
+
+    double max() const
+    {
+        if (m_samples.empty()) return 0.0;
+        return *std::max_element(m_samples.begin(), m_samples.end());
+    }
+
+    QVariantMap summary() const
+    {
+        return QVariantMap{
+            {QStringLiteral("count"), static_cast<qulonglong>(m_total)},
+            {QStringLiteral("last"), m_last},
+            {QStringLiteral("mean"), mean()},
+            {QStringLiteral("p50"), percentile(0.50)},
+            {QStringLiteral("p90"), percentile(0.90)},
+            {QStringLiteral("p99"), percentile(0.99)},
+            {QStringLiteral("max"), max()}
+        };
+    }
+
+private:
+    int m_capacity;
+    int m_next = 0;
+    double m_last = 0.0;
+    quint64 m_total = 0;
+    std::vector<double> m_samples;
+};
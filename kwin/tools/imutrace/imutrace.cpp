@@ -0,0 +1,114 @@
+#include "imutrace.h"
+
+#include <cerrno>
+#include <cstring>
+
+namespace ImuTrace
+{
+
+namespace
+{
+
+template<typename T>
+void putLittleEndian(unsigned char *out, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i) out[i] = static_cast<unsigned char>(static_cast<uint64_t>(value) >> (8 * i));
+}
+
+template<typename T>
+T getLittleEndian(const unsigned char *in)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return static_cast<T>(value);
+}
+
+}
+
+Writer::~Writer() {
+    close();
+}
+
+bool Writer::open(const std::string &path, uint64_t startEpochMs) {
+    close();
+    m_file = fopen(path.c_str(), "wb");
+    if (!m_file) return false;
+    m_lastReceivedUs = 0;
+
+    unsigned char header[HEADER_SIZE] = {};
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    putLittleEndian<uint16_t>(header + 8, FORMAT_VERSION);
+    putLittleEndian<uint16_t>(header + 10, sizeof(ImuLayout::Block));
+    header[12] = ImuLayout::CURRENT_VERSION;
+    putLittleEndian<uint64_t>(header + 16, startEpochMs);
+    return fwrite(header, sizeof(header), 1, m_file) == 1;
+}
+
+bool Writer::append(uint64_t receivedUs, const unsigned char *block) {
+    if (!m_file) return false;
+
+    // a gap of over an hour between two samples is clamped rather than overflowing the delta
+    const uint64_t delta = receivedUs - m_lastReceivedUs;
+    m_lastReceivedUs = receivedUs;
+
+    unsigned char record[RECORD_SIZE];
+    putLittleEndian<uint32_t>(record, delta > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(delta));
+    memcpy(record + sizeof(uint32_t), block, sizeof(ImuLayout::Block));
+    return fwrite(record, sizeof(record), 1, m_file) == 1;
+}
+
+bool Writer::close() {
+    if (!m_file) return true;
+    const bool ok = fclose(m_file) == 0;
+    m_file = nullptr;
+    return ok;
+}
+
+bool read(const std::string &path, Trace &trace, std::string &error) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+
+    unsigned char header[HEADER_SIZE];
+    if (fread(header, sizeof(header), 1, file) != 1 || memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        fclose(file);
+        error = path + ": not an IMU trace";
+        return false;
+    }
+
+    const auto formatVersion = getLittleEndian<uint16_t>(header + 8);
+    const auto blockSize = getLittleEndian<uint16_t>(header + 10);
+    if (formatVersion != FORMAT_VERSION || blockSize != sizeof(ImuLayout::Block)) {
+        fclose(file);
+        error = path + ": trace format " + std::to_string(formatVersion) + " with " + std::to_string(blockSize) +
+                " byte blocks, expected format " + std::to_string(FORMAT_VERSION) + " with " +
+                std::to_string(sizeof(ImuLayout::Block));
+        return false;
+    }
+
+    trace.layoutVersion = header[12];
+    trace.startEpochMs = getLittleEndian<uint64_t>(header + 16);
+    trace.records.clear();
+
+    // a recorder that was killed may leave a partial record at the end, which is dropped
+    unsigned char record[RECORD_SIZE];
+    uint64_t receivedUs = 0;
+    while (fread(record, sizeof(record), 1, file) == 1) {
+        receivedUs += getLittleEndian<uint32_t>(record);
+        Record &entry = trace.records.emplace_back();
+        entry.receivedUs = receivedUs;
+        memcpy(entry.block, record + sizeof(uint32_t), sizeof(entry.block));
+    }
+
+    const bool failed = ferror(file);
+    fclose(file);
+    if (failed) {
+        error = path + ": read error";
+        return false;
+    }
+    return true;
+}
+
+}
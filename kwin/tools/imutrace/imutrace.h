@@ -0,0 +1,58 @@
+#pragma once
+
+#include "imulayout.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Trace files hold every distinct block the driver wrote, each stamped with when the recorder saw it, so a session
+// can be played back into the shared memory file later. All integers are little-endian:
+//
+//   header:  "BRZYIMU\0", uint16 format version, uint16 block size, uint8 layout version, 3 reserved bytes,
+//            uint64 wall clock ms at the start of the recording
+//   records: uint32 microseconds since the previous record (the first one counts from the start), then the raw block
+namespace ImuTrace
+{
+    constexpr char MAGIC[8] = {'B', 'R', 'Z', 'Y', 'I', 'M', 'U', '\0'};
+    constexpr uint16_t FORMAT_VERSION = 1;
+    constexpr size_t HEADER_SIZE = 24;
+    constexpr size_t RECORD_SIZE = sizeof(uint32_t) + sizeof(ImuLayout::Block);
+
+    struct Record {
+        uint64_t receivedUs = 0; // since the start of the recording
+        unsigned char block[sizeof(ImuLayout::Block)];
+    };
+
+    struct Trace {
+        uint8_t layoutVersion = ImuLayout::CURRENT_VERSION;
+        uint64_t startEpochMs = 0;
+        std::vector<Record> records;
+    };
+
+    class Writer
+    {
+    public:
+        Writer() = default;
+        ~Writer();
+
+        Writer(const Writer &) = delete;
+        Writer &operator=(const Writer &) = delete;
+
+        // truncates the file and writes the header; false with errno set on failure
+        bool open(const std::string &path, uint64_t startEpochMs);
+
+        // receivedUs must not go backwards
+        bool append(uint64_t receivedUs, const unsigned char *block);
+
+        bool close();
+
+    private:
+        FILE *m_file = nullptr;
+        uint64_t m_lastReceivedUs = 0;
+    };
+
+    // reads a whole trace, error describes why it couldn't be
+    bool read(const std::string &path, Trace &trace, std::string &error);
+}
@@ -0,0 +1,143 @@
+// Records every block the driver writes to its shared memory file into a trace that breezy_imu_replay can play back,
+// e.g. to capture a judder report on the machine that has the glasses:
+//
+//   breezy_imu_record --output judder.imutrace --duration 30
+//
+// The file is polled rather than watched, because the driver rewrites it in place faster than file notifications
+// are delivered. Blocks caught mid-write are retried on the next poll, and unchanged blocks aren't recorded twice.
+
+#include "imutrace.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+
+std::atomic<bool> stopRequested = false;
+
+void requestStop(int)
+{
+    stopRequested = true;
+}
+
+void printUsage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s --output <trace> [--path <shm file>] [--duration <seconds>] [--interval-us <microseconds>]\n"
+            "\n"
+            "  --output       trace file to write\n"
+            "  --path         shared memory file to read, default %s\n"
+            "  --duration     stop after this many seconds, default until interrupted\n"
+            "  --interval-us  polling interval, default 250\n",
+            program, ImuLayout::SHM_PATH);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    std::string outputPath;
+    std::string shmPath = ImuLayout::SHM_PATH;
+    double durationSeconds = 0.0;
+    long intervalUs = 250;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--output" && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--path" && hasValue) {
+            shmPath = argv[++i];
+        } else if (arg == "--duration" && hasValue) {
+            durationSeconds = atof(argv[++i]);
+        } else if (arg == "--interval-us" && hasValue) {
+            intervalUs = atol(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (outputPath.empty() || intervalUs <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto startEpochMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    ImuTrace::Writer writer;
+    if (!writer.open(outputPath, startEpochMs)) {
+        perror(outputPath.c_str());
+        return 1;
+    }
+
+    int fd = -1;
+    ino_t inode = 0;
+    unsigned char previous[sizeof(ImuLayout::Block)] = {};
+    bool hasPrevious = false;
+    uint64_t recorded = 0;
+    uint64_t torn = 0;
+    uint64_t polls = 0;
+    while (!stopRequested) {
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+        if (durationSeconds > 0.0 && elapsedUs >= durationSeconds * 1e6) break;
+
+        // the driver recreates the file when it restarts, and the old descriptor would keep reading the deleted one
+        struct stat pathStat;
+        if (stat(shmPath.c_str(), &pathStat) != 0 || pathStat.st_ino != inode) {
+            if (fd != -1) close(fd);
+            fd = -1;
+            inode = 0;
+        }
+        if (fd == -1 && (fd = open(shmPath.c_str(), O_RDONLY | O_CLOEXEC)) != -1) {
+            struct stat fileStat;
+            if (fstat(fd, &fileStat) == 0) inode = fileStat.st_ino;
+        }
+        if (fd != -1) {
+            ++polls;
+            unsigned char block[sizeof(ImuLayout::Block)];
+            if (pread(fd, block, sizeof(block), 0) != static_cast<ssize_t>(sizeof(block))) {
+                // still being created or truncated, try again on the next poll
+            } else if (!ImuLayout::View(block, sizeof(block)).parityMatches()) {
+                ++torn;
+            } else if (!hasPrevious || memcmp(block, previous, sizeof(block)) != 0) {
+                if (!writer.append(elapsedUs, block)) {
+                    perror(outputPath.c_str());
+                    break;
+                }
+                memcpy(previous, block, sizeof(block));
+                hasPrevious = true;
+                ++recorded;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(intervalUs));
+    }
+
+    if (fd != -1) close(fd);
+    if (!writer.close()) {
+        perror(outputPath.c_str());
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "recorded %llu samples in %.1f s (%.1f Hz), %llu polls, %llu torn reads\n",
+            static_cast<unsigned long long>(recorded), seconds, seconds > 0.0 ? recorded / seconds : 0.0,
+            static_cast<unsigned long long>(polls), static_cast<unsigned long long>(torn));
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Plays a trace from breezy_imu_record back into a shared memory file, so the effect, the GNOME extension and the
+// benchmarks see the recorded session on a machine without glasses (stop the driver first, or point --path elsewhere):
+//
+//   breezy_imu_replay --input judder.imutrace --speed 1 --loop 3
+//
+// Blocks are written in place, the way the driver writes them. Their poseDateMs is shifted to the replay's wall
+// clock unless --keep-timestamps is given, since consumers ignore a pose that's more than a few seconds old.
+
+#include "imutrace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+
+void printUsage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s --input <trace> [--path <shm file>] [--speed <factor>] [--loop <count>] [--keep-timestamps]\n"
+            "\n"
+            "  --input            trace file to play\n"
+            "  --path             shared memory file to write, default %s\n"
+            "  --speed            playback rate, 2 plays twice as fast, 0 as fast as possible; default 1\n"
+            "  --loop             number of times to play the trace, 0 forever; default 1\n"
+            "  --keep-timestamps  write poseDateMs as recorded instead of shifting it to now\n",
+            program, ImuLayout::SHM_PATH);
+}
+
+uint64_t epochMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    std::string inputPath;
+    std::string shmPath = ImuLayout::SHM_PATH;
+    double speed = 1.0;
+    long loops = 1;
+    bool keepTimestamps = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--input" && hasValue) {
+            inputPath = argv[++i];
+        } else if (arg == "--path" && hasValue) {
+            shmPath = argv[++i];
+        } else if (arg == "--speed" && hasValue) {
+            speed = atof(argv[++i]);
+        } else if (arg == "--loop" && hasValue) {
+            loops = atol(argv[++i]);
+        } else if (arg == "--keep-timestamps") {
+            keepTimestamps = true;
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (inputPath.empty() || speed < 0.0 || loops < 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ImuTrace::Trace trace;
+    std::string error;
+    if (!ImuTrace::read(inputPath, trace, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    if (trace.records.empty()) {
+        fprintf(stderr, "%s: no samples\n", inputPath.c_str());
+        return 1;
+    }
+    if (trace.layoutVersion != ImuLayout::CURRENT_VERSION) {
+        fprintf(stderr, "warning: trace has layout version %u, consumers expect %u\n",
+                static_cast<unsigned>(trace.layoutVersion), static_cast<unsigned>(ImuLayout::CURRENT_VERSION));
+    }
+
+    const int fd = open(shmPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1 || ftruncate(fd, sizeof(ImuLayout::Block)) != 0) {
+        perror(shmPath.c_str());
+        return 1;
+    }
+
+    const uint64_t firstReceivedUs = trace.records.front().receivedUs;
+    const uint64_t firstPoseDateMs = ImuLayout::View(trace.records.front().block, sizeof(ImuLayout::Block)).poseDateMs();
+    const double lengthSeconds = (trace.records.back().receivedUs - firstReceivedUs) / 1e6;
+
+    uint64_t written = 0;
+    uint64_t lateUs = 0;
+    for (long loop = 0; loops == 0 || loop < loops; ++loop) {
+        const auto loopStart = std::chrono::steady_clock::now();
+        const uint64_t loopStartEpochMs = epochMs();
+
+        for (const ImuTrace::Record &record : trace.records) {
+            const uint64_t offsetUs = record.receivedUs - firstReceivedUs;
+            const uint64_t scaledUs = speed > 0.0 ? static_cast<uint64_t>(offsetUs / speed) : 0;
+            if (speed > 0.0) {
+                const auto due = loopStart + std::chrono::microseconds(scaledUs);
+                std::this_thread::sleep_until(due);
+                lateUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - due).count();
+            }
+
+            unsigned char block[sizeof(ImuLayout::Block)];
+            memcpy(block, record.block, sizeof(block));
+            if (!keepTimestamps) {
+                const uint64_t poseDateMs = ImuLayout::View(block, sizeof(block)).poseDateMs();
+                const uint64_t recordedOffsetMs = poseDateMs >= firstPoseDateMs ? poseDateMs - firstPoseDateMs : 0;
+                const uint64_t shiftedOffsetMs = speed > 0.0 ? static_cast<uint64_t>(recordedOffsetMs / speed) : 0;
+                ImuLayout::stampPoseDateMs(block, loopStartEpochMs + shiftedOffsetMs);
+            }
+
+            if (pwrite(fd, block, sizeof(block), 0) != static_cast<ssize_t>(sizeof(block))) {
+                perror(shmPath.c_str());
+                close(fd);
+                return 1;
+            }
+            ++written;
+        }
+    }
+    close(fd);
+
+    fprintf(stderr, "replayed %llu samples from a %.1f s trace at %gx, mean lateness %.1f us\n",
+            static_cast<unsigned long long>(written), lengthSeconds, speed,
+            written > 0 && speed > 0.0 ? static_cast<double>(lateUs) / written : 0.0);
+    return 0;
+}
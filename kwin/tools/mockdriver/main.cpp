@@ -0,0 +1,461 @@
+// Stands in for the XR driver on a machine without glasses: writes version 5 pose blocks at a fixed rate following
+// a scripted motion, keeps the driver state file alive, and acts on the config file and control flags that the
+// effect, the KCM and the GNOME extension write through xrdriveripc.py. For example:
+//
+//   breezy_mock_driver --rate 500 --profile step --duration 60 --log writes.csv
+//
+// Every block write is timestamped; --log keeps one CSV row per write so the effect's pose ingest statistics
+// (RenderStats over DBus) can be compared against what was actually written. Stop the real driver first.
+
+#include "imulayout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little, "blocks are filled in place and must be little-endian");
+
+namespace
+{
+
+constexpr double PI = 3.14159265358979323846;
+constexpr char STATE_PATH[] = "/dev/shm/xr_driver_state";
+constexpr char CONTROL_PATH[] = "/dev/shm/xr_driver_control";
+
+std::atomic<bool> stopRequested = false;
+
+void requestStop(int)
+{
+    stopRequested = true;
+}
+
+struct Options {
+    std::string path = ImuLayout::SHM_PATH;
+    std::string statePath = STATE_PATH;
+    std::string controlPath = CONTROL_PATH;
+    std::string configPath;
+    std::string logPath;
+    std::string profile = "sweep";
+    double rateHz = 250.0;
+    double durationSeconds = 0.0;
+    double calibrateSeconds = 0.5;
+    unsigned seed = 1;
+};
+
+// head angles in degrees, yaw left and pitch up positive, as the motion profiles produce them
+struct Angles {
+    double yaw = 0.0;
+    double pitch = 0.0;
+    double roll = 0.0;
+};
+
+bool knownProfile(const std::string &profile)
+{
+    return profile == "still" || profile == "sweep" || profile == "step" || profile == "circle" || profile == "jitter";
+}
+
+Angles profileAngles(const std::string &profile, double t, std::mt19937 &random)
+{
+    // still holds slightly off center: an identity orientation is how the driver signals it's calibrating
+    if (profile == "still") return {1.0, 0.0, 0.0};
+
+    // slow side to side look across neighbouring displays
+    if (profile == "sweep") return {30.0 * std::sin(2.0 * PI * 0.25 * t), 0.0, 0.0};
+
+    // snaps between two displays every two seconds, for focus changes and smooth follow
+    if (profile == "step") return {std::fmod(t, 4.0) < 2.0 ? -20.0 : 20.0, 0.0, 0.0};
+
+    if (profile == "circle") return {20.0 * std::sin(2.0 * PI * 0.2 * t), 10.0 * std::cos(2.0 * PI * 0.2 * t), 0.0};
+
+    // sensor noise around a fixed pose, for the prediction and dead zone paths
+    std::normal_distribution<double> noise(0.0, 0.05);
+    return {1.0 + noise(random), noise(random), noise(random)};
+}
+
+// NWU, scalar last: yaw about up, then pitch about the left axis, then roll about north
+ImuLayout::Quaternion toQuaternion(const Angles &angles)
+{
+    const double cy = std::cos(angles.yaw * PI / 360.0);
+    const double sy = std::sin(angles.yaw * PI / 360.0);
+    const double cp = std::cos(-angles.pitch * PI / 360.0);
+    const double sp = std::sin(-angles.pitch * PI / 360.0);
+    const double cr = std::cos(angles.roll * PI / 360.0);
+    const double sr = std::sin(angles.roll * PI / 360.0);
+    return {
+        static_cast<float>(sr * cp * cy - cr * sp * sy),
+        static_cast<float>(cr * sp * cy + sr * cp * sy),
+        static_cast<float>(cr * cp * sy - sr * sp * cy),
+        static_cast<float>(cr * cp * cy + sr * sp * sy),
+    };
+}
+
+void setRow(float *rows, int row, const ImuLayout::Quaternion &q)
+{
+    rows[row * 4 + 0] = q.x;
+    rows[row * 4 + 1] = q.y;
+    rows[row * 4 + 2] = q.z;
+    rows[row * 4 + 3] = q.w;
+}
+
+// key=value lines, the format of the driver's state, control and config files
+std::map<std::string, std::string> readKeyValues(const std::string &path)
+{
+    std::map<std::string, std::string> values;
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) return values;
+
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        std::string entry(line);
+        while (!entry.empty() && (entry.back() == '\n' || entry.back() == '\r')) entry.pop_back();
+        const size_t separator = entry.find('=');
+        if (separator == std::string::npos || entry[0] == '#') continue;
+        values[entry.substr(0, separator)] = entry.substr(separator + 1);
+    }
+    fclose(file);
+    return values;
+}
+
+bool isTrue(const std::string &value)
+{
+    return value == "true" || value == "1";
+}
+
+void printUsage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [--rate <hz>] [--profile still|sweep|step|circle|jitter] [--duration <seconds>] [--log <csv>]\n"
+            "          [--path <shm file>] [--state-path <file>] [--control-path <file>] [--config <config.ini>]\n"
+            "          [--calibrate <seconds>] [--seed <n>]\n"
+            "\n"
+            "  --rate          pose writes per second, 60 to 1000; default 250\n"
+            "  --profile       scripted head motion; default sweep\n"
+            "  --duration      stop after this many seconds, default until interrupted\n"
+            "  --log           CSV with one row per write: sequence, monotonic and wall clock write times\n"
+            "  --calibrate     seconds of identity orientation at startup and after a recenter; default 0.5\n"
+            "  --config        driver config to follow, default $XDG_CONFIG_HOME/xr_driver/config.ini\n",
+            program);
+}
+
+class MockDriver
+{
+public:
+    explicit MockDriver(const Options &options)
+        : m_options(options)
+        , m_random(options.seed)
+    {
+        std::memset(&m_block, 0, sizeof(m_block));
+        m_block.version = ImuLayout::CURRENT_VERSION;
+        m_block.enabled = 1;
+        // look-ahead constant, multiplier and scanline time in ms as the effect reads them; the last entry is unused
+        const float lookAheadConfig[4] = {10.0f, 1.0f, 8.0f, 40.0f};
+        std::memcpy(m_block.lookAheadConfig, lookAheadConfig, sizeof(lookAheadConfig));
+        m_block.displayResolution[0] = 1920;
+        m_block.displayResolution[1] = 1080;
+        m_block.displayFov = 46.0f;
+        m_block.lensDistanceRatio = 0.035f;
+        for (int row = 0; row < ImuLayout::ORIENTATION_QUATERNIONS; ++row) {
+            setRow(m_block.poseOrientation, row, {});
+            setRow(m_block.smoothFollowOrigin, row, {});
+        }
+    }
+
+    ~MockDriver()
+    {
+        if (m_fd != -1) close(m_fd);
+        if (m_log) fclose(m_log);
+    }
+
+    bool open()
+    {
+        m_fd = ::open(m_options.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (m_fd == -1 || ftruncate(m_fd, sizeof(ImuLayout::Block)) != 0) {
+            perror(m_options.path.c_str());
+            return false;
+        }
+        if (!m_options.logPath.empty()) {
+            m_log = fopen(m_options.logPath.c_str(), "w");
+            if (!m_log) {
+                perror(m_options.logPath.c_str());
+                return false;
+            }
+            fprintf(m_log, "sequence,scheduled_us,written_us,pose_date_ms,yaw_degrees\n");
+        }
+        return true;
+    }
+
+    int run()
+    {
+        const auto interval = std::chrono::duration<double>(1.0 / m_options.rateHz);
+        const auto start = std::chrono::steady_clock::now();
+        m_calibrateUntil = m_options.calibrateSeconds;
+        auto nextIpc = start;
+
+        uint64_t sequence = 0;
+        std::vector<double> latenessUs;
+        while (!stopRequested) {
+            const auto scheduled = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval * sequence);
+            const double t = std::chrono::duration<double>(scheduled - start).count();
+            if (m_options.durationSeconds > 0.0 && t >= m_options.durationSeconds) break;
+            std::this_thread::sleep_until(scheduled);
+
+            // the files consumers write are checked a few times a second, like the real driver's config watcher
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= nextIpc) {
+                pollControl(t);
+                pollConfig();
+                writeState();
+                nextIpc = now + std::chrono::milliseconds(250);
+            }
+
+            const Angles angles = profileAngles(m_options.profile, t, m_random);
+            const std::optional<uint64_t> poseDateMs = writePose(t, angles);
+            const auto written = std::chrono::steady_clock::now();
+            if (!poseDateMs) {
+                ++sequence;
+                continue;
+            }
+
+            const double scheduledUs = std::chrono::duration<double, std::micro>(scheduled - start).count();
+            const double writtenUs = std::chrono::duration<double, std::micro>(written - start).count();
+            latenessUs.push_back(writtenUs - scheduledUs);
+            if (m_log) {
+                fprintf(m_log, "%llu,%.1f,%.1f,%llu,%.3f\n", static_cast<unsigned long long>(sequence), scheduledUs,
+                        writtenUs, static_cast<unsigned long long>(*poseDateMs), angles.yaw);
+            }
+            ++sequence;
+        }
+
+        // leave the block disabled so consumers shut down promptly rather than waiting for the keep-alive to lapse
+        const uint64_t poseWriteFailures = m_writeFailures;
+        m_block.enabled = 0;
+        writeBlock();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::sort(latenessUs.begin(), latenessUs.end());
+        const auto latenessAt = [&latenessUs](double p) {
+            return latenessUs.empty() ? 0.0 : latenessUs[static_cast<size_t>(p * (latenessUs.size() - 1))];
+        };
+        const uint64_t written = sequence - poseWriteFailures;
+        fprintf(stderr, "wrote %llu poses in %.1f s (%.1f Hz), write lateness p50 %.1f us p99 %.1f us max %.1f us, "
+                        "%llu control flags handled\n",
+                static_cast<unsigned long long>(written), seconds, seconds > 0.0 ? written / seconds : 0.0,
+                latenessAt(0.5), latenessAt(0.99), latenessAt(1.0), static_cast<unsigned long long>(m_controlFlags));
+        if (poseWriteFailures > 0) {
+            fprintf(stderr, "%llu of %llu pose writes failed and were left out of the log\n",
+                    static_cast<unsigned long long>(poseWriteFailures), static_cast<unsigned long long>(sequence));
+            return 1;
+        }
+        return 0;
+    }
+
+private:
+    // a short or failed write is reported once and counted, so the log only ever holds blocks readers could see
+    bool writeBlock()
+    {
+        const ssize_t written = pwrite(m_fd, &m_block, sizeof(m_block), 0);
+        if (written == static_cast<ssize_t>(sizeof(m_block))) return true;
+
+        if (m_writeFailures++ == 0) {
+            if (written < 0) {
+                perror(m_options.path.c_str());
+            } else {
+                fprintf(stderr, "%s: short write of %zd bytes\n", m_options.path.c_str(), written);
+            }
+        }
+        return false;
+    }
+
+    // nullopt if the block couldn't be written; the sample is then dropped from the history as well, so the next
+    // block doesn't claim a predecessor that no reader ever had a chance to see
+    std::optional<uint64_t> writePose(double t, const Angles &angles)
+    {
+        const ImuLayout::Block previous = m_block;
+        const ImuLayout::Quaternion orientation = t < m_calibrateUntil ? ImuLayout::Quaternion{} : toQuaternion(angles);
+        const float timestampMs = static_cast<float>(t * 1000.0);
+
+        // shift the history down a row: row 0 is the newest sample, the last row holds each sample's timestamp
+        float *rows = m_block.poseOrientation;
+        float *timestamps = rows + ImuLayout::ORIENTATION_QUATERNIONS * 4;
+        for (int row = ImuLayout::ORIENTATION_QUATERNIONS - 1; row > 0; --row) {
+            std::memcpy(rows + row * 4, rows + (row - 1) * 4, 4 * sizeof(float));
+            timestamps[row] = timestamps[row - 1];
+        }
+        setRow(rows, 0, orientation);
+        timestamps[0] = timestampMs;
+
+        if (m_smoothFollowPending) {
+            for (int row = 0; row < ImuLayout::ORIENTATION_QUATERNIONS; ++row) setRow(m_block.smoothFollowOrigin, row, orientation);
+            m_smoothFollowPending = false;
+        }
+
+        const uint64_t poseDateMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto *bytes = reinterpret_cast<unsigned char *>(&m_block);
+        ImuLayout::stampPoseDateMs(bytes, poseDateMs);
+        if (!writeBlock()) {
+            m_block = previous;
+            return std::nullopt;
+        }
+        return poseDateMs;
+    }
+
+    // the driver consumes the control file: each key=value line is applied once, then the file is removed
+    void pollControl(double t)
+    {
+        const auto flags = readKeyValues(m_options.controlPath);
+        if (flags.empty()) return;
+        unlink(m_options.controlPath.c_str());
+
+        for (const auto &[key, value] : flags) {
+            ++m_controlFlags;
+            if (key == "recenter_screen" && isTrue(value)) {
+                m_calibrateUntil = t + m_options.calibrateSeconds;
+            } else if (key == "enable_breezy_desktop_smooth_follow" || key == "breezy_desktop_smooth_follow_enabled") {
+                setSmoothFollow(isTrue(value));
+            } else if (key == "toggle_breezy_desktop_smooth_follow" && isTrue(value)) {
+                setSmoothFollow(!m_block.smoothFollowEnabled);
+            } else if (key == "sbs_mode") {
+                m_block.sbsEnabled = value == "enable";
+            } else {
+                fprintf(stderr, "control flag %s=%s accepted, not simulated\n", key.c_str(), value.c_str());
+            }
+        }
+    }
+
+    void setSmoothFollow(bool enabled)
+    {
+        m_block.smoothFollowEnabled = enabled;
+        m_smoothFollowPending = enabled;
+        if (!enabled) {
+            for (int row = 0; row < ImuLayout::ORIENTATION_QUATERNIONS; ++row) setRow(m_block.smoothFollowOrigin, row, {});
+        }
+    }
+
+    // only reloaded when it changes; a missing config leaves the mock enabled
+    void pollConfig()
+    {
+        if (m_options.configPath.empty()) return;
+        struct stat configStat;
+        if (stat(m_options.configPath.c_str(), &configStat) != 0) return;
+        const long long mtimeNs = configStat.st_mtim.tv_sec * 1000000000LL + configStat.st_mtim.tv_nsec;
+        if (mtimeNs == m_configMtimeNs) return;
+        m_configMtimeNs = mtimeNs;
+
+        const auto config = readKeyValues(m_options.configPath);
+        const auto disabled = config.find("disabled");
+        const auto externalMode = config.find("external_mode");
+        const bool breezyMode = externalMode == config.end() || externalMode->second.find("breezy_desktop") != std::string::npos;
+        m_block.enabled = (disabled == config.end() || !isTrue(disabled->second)) && breezyMode;
+    }
+
+    void writeState()
+    {
+        const std::string temporaryPath = m_options.statePath + ".tmp";
+        FILE *file = fopen(temporaryPath.c_str(), "w");
+        if (!file) return;
+
+        const auto heartbeat = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        fprintf(file,
+                "heartbeat=%lld\n"
+                "hardware_id=mock\n"
+                "connected_device_brand=Breezy\n"
+                "connected_device_model=Mock driver\n"
+                "connected_device_full_distance_cm=120\n"
+                "connected_device_full_size_cm=80\n"
+                "connected_device_pose_has_position=false\n"
+                "magnet_supported=false\n"
+                "using_magnet=false\n"
+                "gyro_calibrating=%s\n"
+                "sbs_mode_supported=true\n"
+                "sbs_mode_enabled=%s\n"
+                "breezy_desktop_smooth_follow_enabled=%s\n"
+                "firmware_update_recommended=false\n",
+                static_cast<long long>(heartbeat),
+                m_block.enabled && ImuLayout::View(&m_block, sizeof(m_block)).poseResetState() ? "true" : "false",
+                m_block.sbsEnabled ? "true" : "false", m_block.smoothFollowEnabled ? "true" : "false");
+        fclose(file);
+
+        // replaced in one step so readers never see a half written state
+        rename(temporaryPath.c_str(), m_options.statePath.c_str());
+    }
+
+    Options m_options;
+    std::mt19937 m_random;
+    ImuLayout::Block m_block;
+    int m_fd = -1;
+    FILE *m_log = nullptr;
+    double m_calibrateUntil = 0.0;
+    bool m_smoothFollowPending = false;
+    long long m_configMtimeNs = -1;
+    uint64_t m_controlFlags = 0;
+    uint64_t m_writeFailures = 0;
+};
+
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (const char *configHome = getenv("XDG_CONFIG_HOME"); configHome && *configHome) {
+        options.configPath = std::string(configHome) + "/xr_driver/config.ini";
+    } else if (const char *home = getenv("HOME")) {
+        options.configPath = std::string(home) + "/.config/xr_driver/config.ini";
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--rate" && hasValue) {
+            options.rateHz = atof(argv[++i]);
+        } else if (arg == "--profile" && hasValue) {
+            options.profile = argv[++i];
+        } else if (arg == "--duration" && hasValue) {
+            options.durationSeconds = atof(argv[++i]);
+        } else if (arg == "--log" && hasValue) {
+            options.logPath = argv[++i];
+        } else if (arg == "--path" && hasValue) {
+            options.path = argv[++i];
+        } else if (arg == "--state-path" && hasValue) {
+            options.statePath = argv[++i];
+        } else if (arg == "--control-path" && hasValue) {
+            options.controlPath = argv[++i];
+        } else if (arg == "--config" && hasValue) {
+            options.configPath = argv[++i];
+        } else if (arg == "--calibrate" && hasValue) {
+            options.calibrateSeconds = atof(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(atol(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.rateHz < 60.0 || options.rateHz > 1000.0 || !knownProfile(options.profile)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+
+    MockDriver driver(options);
+    if (!driver.open()) return 1;
+    return driver.run();
+}
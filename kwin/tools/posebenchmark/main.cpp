@@ -0,0 +1,277 @@
+// Checks and times the pose decode path the effect runs for every block the driver writes, without KWin or glasses:
+//
+//   breezy_pose_benchmark --iterations 1000000 --trace judder.imutrace
+//
+// Each synthetic case (valid, torn, wrong version, disabled, stale keep-alive, reset state) and every block of an
+// optional recorded trace is classified with BreezyPose::classifyBlock(), the function updatePose() acts on, and read
+// back through a PoseReader from a file, the way the effect reads it; the run fails if either disagrees with the
+// expected outcome. Then each case is decoded repeatedly and reported in ns/sample, so a refactor of the hot path can
+// be compared against the previous build. Exits non-zero if any check fails; ctest runs it with a short iteration
+// count.
+
+#include "imutrace.h"
+#include "posereader.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QQuaternion>
+#include <QTemporaryDir>
+#include <QVector3D>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+constexpr double PI = 3.14159265358979323846;
+
+// the wall clock all synthetic blocks are judged against, so the cases don't depend on when the benchmark runs
+constexpr quint64 NOW_MS = 1750000000000ULL;
+
+using BlockBytes = std::vector<unsigned char>;
+
+// NWU, scalar last, from yaw left and pitch up in degrees
+ImuLayout::Quaternion nwuQuaternion(double yawDegrees, double pitchDegrees)
+{
+    const double cy = std::cos(yawDegrees * PI / 360.0);
+    const double sy = std::sin(yawDegrees * PI / 360.0);
+    const double cp = std::cos(-pitchDegrees * PI / 360.0);
+    const double sp = std::sin(-pitchDegrees * PI / 360.0);
+    return {static_cast<float>(-sp * sy), static_cast<float>(sp * cy), static_cast<float>(cp * sy), static_cast<float>(cp * cy)};
+}
+
+void setRow(float *rows, int row, const ImuLayout::Quaternion &q)
+{
+    rows[row * 4 + 0] = q.x;
+    rows[row * 4 + 1] = q.y;
+    rows[row * 4 + 2] = q.z;
+    rows[row * 4 + 3] = q.w;
+}
+
+// a block as the driver writes it, looking 30 degrees left and 10 up, with one sample every 2 ms
+BlockBytes makeBlock(uint8_t version, quint64 poseDateMs, const ImuLayout::Quaternion &orientation)
+{
+    ImuLayout::Block block;
+    std::memset(&block, 0, sizeof(block));
+    block.version = version;
+    block.enabled = 1;
+    block.displayResolution[0] = 1920;
+    block.displayResolution[1] = 1080;
+    block.displayFov = 46.0f;
+    block.lensDistanceRatio = 0.035f;
+    for (int row = 0; row < ImuLayout::ORIENTATION_QUATERNIONS; ++row) {
+        setRow(block.poseOrientation, row, orientation);
+        setRow(block.smoothFollowOrigin, row, {});
+    }
+    float *timestamps = block.poseOrientation + ImuLayout::ORIENTATION_QUATERNIONS * 4;
+    timestamps[0] = 1004.0f;
+    timestamps[1] = 1002.0f;
+    timestamps[2] = 1000.0f;
+
+    BlockBytes bytes(sizeof(block));
+    std::memcpy(bytes.data(), &block, sizeof(block));
+    ImuLayout::stampPoseDateMs(bytes.data(), poseDateMs);
+    return bytes;
+}
+
+const char *statusName(BreezyPose::PoseStatus status)
+{
+    switch (status) {
+    case BreezyPose::PoseStatus::Torn:
+        return "torn";
+    case BreezyPose::PoseStatus::WrongVersion:
+        return "wrong version";
+    case BreezyPose::PoseStatus::Disabled:
+        return "disabled";
+    case BreezyPose::PoseStatus::Stale:
+        return "stale";
+    case BreezyPose::PoseStatus::Reset:
+        return "reset";
+    case BreezyPose::PoseStatus::Tracking:
+        return "tracking";
+    }
+    return "?";
+}
+
+// everything updatePose() reads from a snapshot, folded into a value so the work can't be optimized away
+float consume(const BreezyPose::PoseSnapshot &pose)
+{
+    return static_cast<float>(pose.status) + pose.lookAheadConfig[0] + pose.displayResolution.width() + pose.diagonalFov +
+           pose.lensDistanceRatio + pose.position.x() + pose.orientation.scalar() + pose.previousOrientation.scalar() +
+           (pose.orientationTimestampMs - pose.previousOrientationTimestampMs) + pose.smoothFollowOrigin.scalar() +
+           pose.previousSmoothFollowOrigin.scalar() + pose.sbsEnabled + pose.customBannerEnabled + pose.smoothFollowEnabled;
+}
+
+bool writeFile(const QString &path, const BlockBytes &bytes)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) &&
+           file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size()) == static_cast<qint64>(bytes.size());
+}
+
+bool near(float actual, float expected)
+{
+    return std::abs(actual - expected) < 0.01f;
+}
+
+template<typename Function>
+double nsPerSample(qint64 iterations, Function &&function)
+{
+    volatile float sink = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (qint64 i = 0; i < iterations; ++i) sink = sink + function();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+struct Case {
+    const char *name;
+    BlockBytes bytes;
+    BreezyPose::PoseStatus expected;
+};
+
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("breezy_pose_benchmark"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Correctness checks and timings for the Breezy Desktop pose decode path"));
+    parser.addHelpOption();
+    parser.addOptions({
+        {QStringLiteral("iterations"), QStringLiteral("Decodes timed per case."), QStringLiteral("count"), QStringLiteral("1000000")},
+        {QStringLiteral("trace"), QStringLiteral("Also check and time the blocks of a breezy_imu_record trace."), QStringLiteral("file")},
+    });
+    parser.process(app);
+
+    const qint64 iterations = std::max(parser.value(QStringLiteral("iterations")).toLongLong(), 1LL);
+    const qint64 nowMs = static_cast<qint64>(NOW_MS);
+    const ImuLayout::Quaternion looking = nwuQuaternion(30.0, 10.0);
+
+    using BreezyPose::PoseStatus;
+    std::vector<Case> cases;
+    cases.push_back({"valid", makeBlock(ImuLayout::CURRENT_VERSION, NOW_MS - 2, looking), PoseStatus::Tracking});
+    BlockBytes torn = makeBlock(ImuLayout::CURRENT_VERSION, NOW_MS - 2, looking);
+    torn[offsetof(ImuLayout::Block, poseOrientation) + 1] ^= 0x40; // a write landing between the data and the parity
+    cases.push_back({"torn", torn, PoseStatus::Torn});
+    cases.push_back({"wrong version", makeBlock(ImuLayout::CURRENT_VERSION - 1, NOW_MS - 2, looking), PoseStatus::WrongVersion});
+    BlockBytes disabled = makeBlock(ImuLayout::CURRENT_VERSION, NOW_MS - 2, looking);
+    disabled[offsetof(ImuLayout::Block, enabled)] = 0;
+    cases.push_back({"disabled", disabled, PoseStatus::Disabled});
+    cases.push_back({"stale keep-alive", makeBlock(ImuLayout::CURRENT_VERSION, NOW_MS - BreezyPose::KEEP_ALIVE_MS - 1, looking), PoseStatus::Stale});
+    cases.push_back({"reset state", makeBlock(ImuLayout::CURRENT_VERSION, NOW_MS - 2, ImuLayout::Quaternion{}), PoseStatus::Reset});
+
+    int failures = 0;
+    const auto check = [&failures](bool ok, const char *what) {
+        if (!ok) {
+            fprintf(stderr, "FAIL %s\n", what);
+            ++failures;
+        }
+    };
+
+    QTemporaryDir shmDir;
+    if (!shmDir.isValid()) {
+        fprintf(stderr, "can't create a temporary directory for the pose file\n");
+        return 1;
+    }
+    const QString shmPath = shmDir.filePath(QStringLiteral("breezy_pose"));
+    BreezyPose::PoseReader reader(shmPath);
+    quint64 expectedTornReads = 0;
+
+    for (const Case &testCase : cases) {
+        const ImuLayout::View block(testCase.bytes.data(), testCase.bytes.size());
+        const PoseStatus status = BreezyPose::classifyBlock(block, nowMs);
+        if (status != testCase.expected) {
+            fprintf(stderr, "FAIL %s: classified as %s, expected %s\n", testCase.name, statusName(status), statusName(testCase.expected));
+            ++failures;
+        }
+
+        // the same block through the file, as updatePose() sees it: torn reads are dropped and counted
+        if (!writeFile(shmPath, testCase.bytes)) {
+            fprintf(stderr, "FAIL %s: can't write %s\n", testCase.name, qPrintable(shmPath));
+            ++failures;
+            continue;
+        }
+        const auto pose = reader.read(nowMs);
+        if (testCase.expected == PoseStatus::Torn) {
+            ++expectedTornReads;
+            check(!pose, "a torn block must not be returned by the reader");
+        } else if (!pose || pose->status != testCase.expected) {
+            fprintf(stderr, "FAIL %s: read back as %s, expected %s\n", testCase.name, pose ? statusName(pose->status) : "nothing",
+                    statusName(testCase.expected));
+            ++failures;
+        }
+    }
+    check(reader.tornReads() == expectedTornReads, "torn reads counted by the reader");
+    check(!ImuLayout::View(cases[0].bytes.data(), cases[0].bytes.size() - 1).isValid(), "a short buffer must not be a valid view");
+    check(BreezyPose::isActive(PoseStatus::Reset) && BreezyPose::isActive(PoseStatus::Tracking) &&
+              !BreezyPose::isActive(PoseStatus::Stale) && !BreezyPose::isActive(PoseStatus::Disabled),
+          "only reset and tracking blocks keep the effect running");
+
+    // 30 degrees left and 10 up in NWU is a positive yaw about y and a positive pitch about x in EUS
+    const ImuLayout::View valid(cases[0].bytes.data(), cases[0].bytes.size());
+    const BreezyPose::PoseSnapshot pose = BreezyPose::decodePose(valid, nowMs);
+    const QVector3D euler = pose.orientation.toEulerAngles();
+    check(near(euler.y(), 30.0f) && near(euler.x(), 10.0f) && near(euler.z(), 0.0f), "NWU to EUS orientation");
+    check(pose.displayResolution == QSize(1920, 1080) && pose.poseDateMs == NOW_MS - 2, "decodePose fields");
+    check(near(pose.orientationTimestampMs - pose.previousOrientationTimestampMs, 2.0f), "decodePose sample interval");
+
+    ImuTrace::Trace trace;
+    if (parser.isSet(QStringLiteral("trace"))) {
+        std::string error;
+        if (!ImuTrace::read(parser.value(QStringLiteral("trace")).toStdString(), trace, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+
+        // the recorder only keeps blocks whose parity matched, so every one of them should decode, judged against
+        // the wall clock it was recorded at
+        for (const ImuTrace::Record &record : trace.records) {
+            const ImuLayout::View block(record.block, sizeof(record.block));
+            const PoseStatus status = BreezyPose::classifyBlock(block, static_cast<qint64>(block.poseDateMs()));
+            if (status == PoseStatus::Torn || status == PoseStatus::WrongVersion) {
+                fprintf(stderr, "FAIL trace block at %llu us doesn't decode\n", static_cast<unsigned long long>(record.receivedUs));
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+
+    printf("%-18s %12s\n", "case", "ns/sample");
+    for (const Case &testCase : cases) {
+        const ImuLayout::View block(testCase.bytes.data(), testCase.bytes.size());
+        printf("%-18s %12.1f\n", testCase.name, nsPerSample(iterations, [&block, nowMs] { return consume(BreezyPose::decodePose(block, nowMs)); }));
+    }
+    if (!trace.records.empty()) {
+        size_t next = 0;
+        const double ns = nsPerSample(iterations, [&trace, &next] {
+            const ImuTrace::Record &record = trace.records[next];
+            next = next + 1 == trace.records.size() ? 0 : next + 1;
+            const ImuLayout::View block(record.block, sizeof(record.block));
+            return consume(BreezyPose::decodePose(block, static_cast<qint64>(block.poseDateMs())));
+        });
+        printf("%-18s %12.1f  (%zu recorded blocks)\n", "trace", ns, trace.records.size());
+    }
+
+    // the whole of what updatePose() does before acting on the pose: stat, pread, classify and decode
+    writeFile(shmPath, cases[0].bytes);
+    printf("%-18s %12.1f\n", "parity only", nsPerSample(iterations, [&valid] { return valid.parityMatches() ? 1.0f : 0.0f; }));
+    printf("%-18s %12.1f\n", "PoseReader::read", nsPerSample(iterations, [&reader, nowMs] {
+        const auto pose = reader.read(nowMs);
+        return pose ? consume(*pose) : 0.0f;
+    }));
+    return 0;
+}
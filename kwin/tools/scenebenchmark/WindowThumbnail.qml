@@ -0,0 +1,32 @@
+import QtQuick
+import org.kde.kwin as KWinComponents
+
+// Stands in for a window's live texture: a dark surface full of small text, which is the
+// high-frequency content that makes display texture filtering and antialiasing expensive.
+Rectangle {
+    id: thumbnail
+
+    property var wId
+    readonly property QtObject window: KWinComponents.Workspace.windowForId(wId)
+
+    width: window ? window.width : 0
+    height: window ? window.height : 0
+    color: "#1e1e1e"
+    clip: true
+
+    Column {
+        anchors.fill: parent
+        anchors.margins: 8
+
+        Repeater {
+            model: Math.floor(thumbnail.height / 18)
+
+            Text {
+                text: "The quick brown fox jumps over the lazy dog 0123456789 {}[]();:<>=+-*/"
+                color: "#d0d0d0"
+                font.family: "monospace"
+                font.pixelSize: 14
+            }
+        }
+    }
+}
@@ -0,0 +1,308 @@
+// Renders the effect's QtQuick3D scene offscreen with mocked KWin and effect objects and reports frame time
+// percentiles for each antialiasing mode. Intended to run without KWin or glasses, e.g. on llvmpipe in CI:
+//
+//   breezy_scene_benchmark --software --displays 3 --resolution 2560x1440 --curved --aa all
+//
+// Run once with and once without --compiled to compare the ahead-of-time compiled scene the effect ships against
+// compiling the same QML at load time; the "load" line covers compiling and instantiating the scene.
+//
+// Before rendering, CameraController.qml from the same module places a camera for a pose whose look-ahead is known,
+// and the run fails if the predicted rotation is wrong. ctest runs just those checks with --checks-only, once for
+// each of the compiled and source paths.
+
+#include "mockeffect.h"
+#include "mockkwin.h"
+#include "rollingsamples.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickGraphicsDevice>
+#include <QQuickItem>
+#include <QQuickRenderControl>
+#include <QQuickRenderTarget>
+#include <QQuickWindow>
+#include <QtQuick3D/qquick3d.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+
+QSize parseSize(const QString &value, const QSize &fallback)
+{
+    const QStringList parts = value.split(QLatin1Char('x'));
+    if (parts.size() != 2) return fallback;
+
+    bool widthOk = false;
+    bool heightOk = false;
+    const QSize size(parts[0].toInt(&widthOk), parts[1].toInt(&heightOk));
+    return widthOk && heightOk && !size.isEmpty() ? size : fallback;
+}
+
+QList<int> parseAntialiasingModes(const QString &value)
+{
+    if (value == QLatin1String("all")) return {0, 1, 2, 3, 4, 5, 6};
+
+    QList<int> modes;
+    for (const QString &mode : value.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int quality = mode.toInt(&ok);
+        if (ok && quality >= 0 && quality <= 6) modes.append(quality);
+    }
+    return modes;
+}
+
+bool near(const QVector3D &actual, const QVector3D &expected)
+{
+    return (actual - expected).length() < 0.01f;
+}
+
+// The pose is 4 ms apart at 10 degrees of yaw and 2 of pitch, moving 0.5 and 0.1 degrees per ms. It was sampled at
+// 1008 ms and the frame presents at 1020, so with the default 10 ms constant the camera looks 22 ms ahead. The checks
+// have their own engine so the benchmark's load timing doesn't find CameraController already compiled.
+int checkLookAhead()
+{
+    QQmlEngine engine;
+    int failures = 0;
+    const auto check = [&failures](bool ok, const char *what) {
+        if (!ok) {
+            fprintf(stderr, "FAIL %s\n", what);
+            ++failures;
+        }
+    };
+
+    MockBreezyEffect effect;
+    QQmlComponent cameraComponent(&engine);
+    cameraComponent.setData("import QtQuick3D\nCustomCamera {}", QUrl());
+    std::unique_ptr<QObject> camera(cameraComponent.create());
+
+    const QUrl cameraControllerQml(QStringLiteral("qrc:/org/kde/kwin/effect/breezy_desktop/scene/CameraController.qml"));
+    QQmlComponent component(&engine, cameraControllerQml);
+    std::unique_ptr<QObject> cameraController(component.createWithInitialProperties({
+        {QStringLiteral("effect"), QVariant::fromValue<QObject *>(&effect)},
+        {QStringLiteral("camera"), QVariant::fromValue<QObject *>(camera.get())},
+        {QStringLiteral("fovDetails"), QVariantMap{{QStringLiteral("lensDistancePixels"), 100.0}, {QStringLiteral("fullScreenDistancePixels"), 1000.0}}},
+    }));
+    if (!camera || !cameraController) {
+        fprintf(stderr, "failed to load %s: %s%s\n", qPrintable(cameraControllerQml.toString()),
+                qPrintable(cameraComponent.errorString()), qPrintable(component.errorString()));
+        return 1;
+    }
+
+    const QList<QQuaternion> orientations{QQuaternion::fromEulerAngles(2.0f, 10.0f, 0.0f), QQuaternion::fromEulerAngles(1.6f, 8.0f, 0.0f)};
+    effect.prepareFrame(orientations, 1008, 1020.0);
+
+    double lookAheadMs = 0.0;
+    QMetaObject::invokeMethod(cameraController.get(), "lookAheadMS", Q_RETURN_ARG(double, lookAheadMs),
+                              Q_ARG(double, 1008.0), Q_ARG(double, 10.0), Q_ARG(double, -1.0));
+    check(std::abs(lookAheadMs - 22.0) < 0.001, "lookAheadMS adds the pose's age at presentation to the constant");
+    QMetaObject::invokeMethod(cameraController.get(), "lookAheadMS", Q_RETURN_ARG(double, lookAheadMs),
+                              Q_ARG(double, 1008.0), Q_ARG(double, 10.0), Q_ARG(double, 5.0));
+    check(std::abs(lookAheadMs - 17.0) < 0.001, "lookAheadMS uses the override in place of the constant");
+
+    QVector3D predicted;
+    QMetaObject::invokeMethod(cameraController.get(), "applyLookAhead", Q_RETURN_ARG(QVector3D, predicted),
+                              Q_ARG(QVector3D, QVector3D(2.0f, 10.0f, 0.0f)), Q_ARG(QVector3D, QVector3D(0.1f, 0.5f, 0.0f)), Q_ARG(double, 22.0));
+    check(near(predicted, QVector3D(4.2f, 21.0f, 0.0f)), "applyLookAhead extrapolates the euler angles at the given rates");
+
+    // framePrepared placed the camera through ratesOfChange, lookAheadMS and applyLookAhead together
+    check(near(camera->property("eulerRotation").value<QVector3D>(), QVector3D(4.2f, 21.0f, 0.0f)),
+          "the camera is rotated to the predicted pose for the frame's presentation");
+
+    if (failures > 0) fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    // must be decided before the platform and GL driver are loaded
+    const bool software = std::any_of(argv, argv + argc, [](const char *arg) { return qstrcmp(arg, "--software") == 0; });
+    if (software) qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+
+    // the scene always comes from the compiled module; without --compiled the engine ignores the compilation units
+    // built into the binary (and its disk cache) and compiles the QML source that's embedded alongside them
+    const bool compiled = std::any_of(argv, argv + argc, [](const char *arg) { return qstrcmp(arg, "--compiled") == 0; });
+    if (!compiled) qputenv("QML_DISABLE_DISK_CACHE", "1");
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("breezy_scene_benchmark"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Offscreen render benchmark for the Breezy Desktop QtQuick3D scene"));
+    parser.addHelpOption();
+    parser.addOptions({
+        {QStringLiteral("software"), QStringLiteral("Force Mesa's software rasterizer (llvmpipe).")},
+        {QStringLiteral("displays"), QStringLiteral("Number of virtual displays."), QStringLiteral("count"), QStringLiteral("3")},
+        {QStringLiteral("resolution"), QStringLiteral("Resolution of each virtual display."), QStringLiteral("WxH"), QStringLiteral("1920x1080")},
+        {QStringLiteral("output"), QStringLiteral("Resolution of the glasses output being rendered."), QStringLiteral("WxH"), QStringLiteral("1920x1080")},
+        {QStringLiteral("curved"), QStringLiteral("Render curved displays.")},
+        {QStringLiteral("sbs"), QStringLiteral("Render side-by-side for both eyes.")},
+        {QStringLiteral("aa"), QStringLiteral("Comma separated antialiasing modes (0-6) or \"all\"."), QStringLiteral("modes"), QStringLiteral("all")},
+        {QStringLiteral("filtering"), QStringLiteral("Display texture filtering (0-2)."), QStringLiteral("mode"), QStringLiteral("0")},
+        {QStringLiteral("frames"), QStringLiteral("Measured frames per mode."), QStringLiteral("count"), QStringLiteral("300")},
+        {QStringLiteral("warmup"), QStringLiteral("Unmeasured frames before each mode."), QStringLiteral("count"), QStringLiteral("60")},
+        {QStringLiteral("damage-every"), QStringLiteral("Damage every display each N frames, 0 for never."), QStringLiteral("frames"), QStringLiteral("1")},
+        {QStringLiteral("compiled"), QStringLiteral("Use the ahead-of-time compiled scene instead of compiling its QML at load time.")},
+        {QStringLiteral("checks-only"), QStringLiteral("Run the camera look-ahead checks and exit without rendering.")},
+    });
+    parser.process(app);
+
+    if (checkLookAhead() > 0) return 1;
+    if (parser.isSet(QStringLiteral("checks-only"))) return 0;
+
+    const int displayCount = std::max(1, parser.value(QStringLiteral("displays")).toInt());
+    const QSize displaySize = parseSize(parser.value(QStringLiteral("resolution")), QSize(1920, 1080));
+    const QSize outputSize = parseSize(parser.value(QStringLiteral("output")), QSize(1920, 1080));
+    const QList<int> antialiasingModes = parseAntialiasingModes(parser.value(QStringLiteral("aa")));
+    const int frames = std::max(1, parser.value(QStringLiteral("frames")).toInt());
+    const int warmupFrames = std::max(0, parser.value(QStringLiteral("warmup")).toInt());
+    const int damageEvery = std::max(0, parser.value(QStringLiteral("damage-every")).toInt());
+    if (antialiasingModes.isEmpty()) {
+        fprintf(stderr, "no valid antialiasing modes given\n");
+        return 1;
+    }
+
+    QSurfaceFormat::setDefaultFormat(QQuick3D::idealSurfaceFormat());
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::OpenGL);
+
+    QOpenGLContext context;
+    context.setFormat(QSurfaceFormat::defaultFormat());
+    if (!context.create()) {
+        fprintf(stderr, "failed to create an OpenGL context\n");
+        return 1;
+    }
+    QOffscreenSurface surface;
+    surface.setFormat(context.format());
+    surface.create();
+    if (!context.makeCurrent(&surface)) {
+        fprintf(stderr, "failed to make the OpenGL context current\n");
+        return 1;
+    }
+    fprintf(stdout, "renderer: %s\n", reinterpret_cast<const char *>(context.functions()->glGetString(GL_RENDERER)));
+
+    // the glasses output first, then the virtual displays laid out in a row to its right
+    MockWorkspace workspace;
+    auto *targetScreen = new MockScreen(QStringLiteral("XR-0"), QStringLiteral("XREAL One"), QRect(QPoint(0, 0), outputSize));
+    workspace.addScreen(targetScreen);
+    QStringList screenNames{targetScreen->name()};
+    int x = outputSize.width();
+    for (int i = 0; i < displayCount; ++i) {
+        const QRect geometry(QPoint(x, 0), displaySize);
+        auto *screen = new MockScreen(QStringLiteral("BreezyDesktop_%1").arg(i), QStringLiteral("Virtual"), geometry);
+        workspace.addScreen(screen);
+        screenNames.append(screen->name());
+
+        // two overlapping windows per display so thumbnails have something to draw
+        workspace.addWindow(new MockWindow(QRectF(geometry.x() + 40, geometry.y() + 40, geometry.width() * 0.6, geometry.height() * 0.7), 2 * i));
+        workspace.addWindow(new MockWindow(QRectF(geometry.x() + geometry.width() * 0.35, geometry.y() + geometry.height() * 0.25,
+                                                  geometry.width() * 0.6, geometry.height() * 0.7), 2 * i + 1));
+        x += displaySize.width();
+    }
+    registerMockKWinTypes(&workspace);
+
+    MockBreezyEffect effect;
+    effect.setDisplayResolution(outputSize);
+    effect.setCurvedDisplay(parser.isSet(QStringLiteral("curved")));
+    effect.setSbsEnabled(parser.isSet(QStringLiteral("sbs")));
+    effect.setTextureFiltering(parser.value(QStringLiteral("filtering")).toInt());
+
+    QQuickRenderControl renderControl;
+    QQuickWindow window(&renderControl);
+    window.setGraphicsDevice(QQuickGraphicsDevice::fromOpenGLContext(&context));
+    if (!renderControl.initialize()) {
+        fprintf(stderr, "failed to initialize QQuickRenderControl\n");
+        return 1;
+    }
+    QOpenGLFramebufferObject framebuffer(outputSize, QOpenGLFramebufferObject::CombinedDepthStencil);
+    window.setRenderTarget(QQuickRenderTarget::fromOpenGLTexture(framebuffer.texture(), outputSize));
+    window.setGeometry(QRect(QPoint(0, 0), outputSize));
+    window.contentItem()->setSize(outputSize);
+
+    QQmlEngine engine;
+    const QUrl mainQml(QStringLiteral("qrc:/org/kde/kwin/effect/breezy_desktop/scene/main.qml"));
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    QQmlComponent component(&engine, mainQml);
+    const qint64 compileNs = loadTimer.nsecsElapsed();
+    std::unique_ptr<QObject> rootObject(component.createWithInitialProperties({
+        {QStringLiteral("effect"), QVariant::fromValue<QObject *>(&effect)},
+        {QStringLiteral("targetScreen"), QVariant::fromValue<QObject *>(targetScreen)},
+    }));
+    auto *rootItem = qobject_cast<QQuickItem *>(rootObject.get());
+    if (!rootItem) {
+        fprintf(stderr, "failed to load %s: %s\n", qPrintable(mainQml.toString()), qPrintable(component.errorString()));
+        return 1;
+    }
+    rootItem->setParentItem(window.contentItem());
+    rootItem->setSize(outputSize);
+    const qint64 loadNs = loadTimer.nsecsElapsed();
+
+    // the pose clock advances a fixed 60Hz step per frame so every run sees the same motion
+    qint64 poseTimeMs = 0;
+    int frameNumber = 0;
+    auto renderFrame = [&]() {
+        poseTimeMs += 1000 / 60;
+        effect.prepareFrame(poseTimeMs);
+        if (frameNumber == 0 || (damageEvery > 0 && frameNumber % damageEvery == 0)) {
+            Q_EMIT effect.displayTexturesDamaged(screenNames);
+        }
+        ++frameNumber;
+
+        renderControl.polishItems();
+        renderControl.beginFrame();
+        renderControl.sync();
+        renderControl.render();
+        renderControl.endFrame();
+
+        // wait for the GPU so the wall time covers the frame's rendering, not just its submission
+        context.functions()->glFinish();
+    };
+
+    // the first frame also builds the scene's meshes, materials and pipelines, so it's part of the startup cost
+    loadTimer.start();
+    renderFrame();
+    const qint64 firstFrameNs = loadTimer.nsecsElapsed();
+    fprintf(stdout, "load source=%s compile=%.2f create=%.2f first-frame=%.2f ms\n",
+            compiled ? "compiled" : "qml", compileNs / 1e6, (loadNs - compileNs) / 1e6, firstFrameNs / 1e6);
+
+    fprintf(stdout, "displays=%d resolution=%dx%d output=%dx%d curved=%d sbs=%d filtering=%d damage-every=%d\n",
+            displayCount, displaySize.width(), displaySize.height(), outputSize.width(), outputSize.height(),
+            effect.property("curvedDisplay").toBool(), effect.property("sbsEnabled").toBool(),
+            effect.property("textureFiltering").toInt(), damageEvery);
+
+    for (int mode : antialiasingModes) {
+        effect.setAntialiasingQuality(mode);
+        for (int i = 0; i < warmupFrames; ++i) renderFrame();
+
+        RollingSamples frameTimesMs(frames);
+        QElapsedTimer timer;
+        for (int i = 0; i < frames; ++i) {
+            timer.start();
+            renderFrame();
+            frameTimesMs.add(timer.nsecsElapsed() / 1e6);
+        }
+
+        fprintf(stdout, "aa=%d frames=%d mean=%.2f p50=%.2f p90=%.2f p99=%.2f max=%.2f ms\n",
+                mode, frames, frameTimesMs.mean(), frameTimesMs.percentile(0.5), frameTimesMs.percentile(0.9),
+                frameTimesMs.percentile(0.99), frameTimesMs.max());
+        fflush(stdout);
+    }
+
+    rootObject.reset();
+    context.doneCurrent();
+    return 0;
+}
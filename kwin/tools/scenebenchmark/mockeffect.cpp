@@ -0,0 +1,61 @@
+#include "mockeffect.h"
+
+#include <cmath>
+
+MockBreezyEffect::MockBreezyEffect(QObject *parent)
+    : QObject(parent)
+{
+    m_poseOrientations = {QQuaternion(), QQuaternion()};
+    m_smoothFollowOrigin = m_poseOrientations;
+}
+
+void MockBreezyEffect::setAntialiasingQuality(int quality)
+{
+    m_antialiasingQuality = quality;
+    Q_EMIT settingsChanged();
+}
+
+void MockBreezyEffect::setTextureFiltering(int filtering)
+{
+    m_textureFiltering = filtering;
+    Q_EMIT settingsChanged();
+}
+
+void MockBreezyEffect::setCurvedDisplay(bool curved)
+{
+    m_curvedDisplay = curved;
+    Q_EMIT settingsChanged();
+}
+
+void MockBreezyEffect::setSbsEnabled(bool enabled)
+{
+    m_sbsEnabled = enabled;
+    Q_EMIT settingsChanged();
+}
+
+void MockBreezyEffect::setDisplayResolution(const QSize &resolution)
+{
+    m_displayResolution = {static_cast<quint32>(resolution.width()), static_cast<quint32>(resolution.height())};
+}
+
+// a slow look around: +/-20 degrees of yaw and +/-8 of pitch, the range over which several displays pass through view
+QQuaternion MockBreezyEffect::poseAt(qint64 timeMs) const
+{
+    const double seconds = timeMs / 1000.0;
+    const float yaw = 20.0f * std::sin(2.0 * M_PI * seconds / 4.0);
+    const float pitch = 8.0f * std::sin(2.0 * M_PI * seconds / 3.0);
+    return QQuaternion::fromEulerAngles(pitch, yaw, 0.0f);
+}
+
+void MockBreezyEffect::prepareFrame(qint64 timeMs)
+{
+    prepareFrame({poseAt(timeMs), poseAt(timeMs - m_poseTimeElapsedMs)}, static_cast<quint64>(timeMs), timeMs);
+}
+
+void MockBreezyEffect::prepareFrame(const QList<QQuaternion> &orientations, quint64 poseTimestamp, qreal predictedPresentTimestamp)
+{
+    m_poseTimestamp = poseTimestamp;
+    m_poseOrientations = orientations;
+    m_predictedPresentTimestamp = predictedPresentTimestamp;
+    Q_EMIT framePrepared();
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QPointF>
+#include <QQuaternion>
+#include <QSize>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector3D>
+#include <qqmlregistration.h>
+
+// Stands in for BreezyDesktopEffect: the properties and signals the QML scene reads, with device values
+// typical of current glasses and a synthetic head pose that keeps the camera moving. It takes the effect's name in
+// this tool's copy of the scene module, so the scene's typed "effect" properties are compiled against it.
+class MockBreezyEffect : public QObject
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(BreezyDesktopEffect)
+    QML_UNCREATABLE("BreezyDesktop cannot be created in QML")
+    Q_PROPERTY(bool isEnabled MEMBER m_isEnabled CONSTANT FINAL)
+    Q_PROPERTY(int effectTargetScreenIndex MEMBER m_effectTargetScreenIndex FINAL)
+    Q_PROPERTY(bool zoomOnFocusEnabled MEMBER m_zoomOnFocusEnabled CONSTANT FINAL)
+    Q_PROPERTY(int lookingAtScreenIndex MEMBER m_lookingAtScreenIndex FINAL)
+    Q_PROPERTY(QString lookingAtScreenName MEMBER m_lookingAtScreenName NOTIFY lookingAtScreenNameChanged FINAL)
+    Q_PROPERTY(qreal peripheralTextureScale MEMBER m_peripheralTextureScale CONSTANT FINAL)
+    Q_PROPERTY(bool poseResetState MEMBER m_poseResetState CONSTANT FINAL)
+    Q_PROPERTY(bool poseHasPosition MEMBER m_poseHasPosition CONSTANT FINAL)
+    Q_PROPERTY(QList<QQuaternion> poseOrientations MEMBER m_poseOrientations FINAL)
+    Q_PROPERTY(QVector3D posePosition MEMBER m_posePosition FINAL)
+    Q_PROPERTY(quint32 poseTimeElapsedMs MEMBER m_poseTimeElapsedMs FINAL)
+    Q_PROPERTY(quint64 poseTimestamp MEMBER m_poseTimestamp FINAL)
+    Q_PROPERTY(qreal predictedPresentTimestamp MEMBER m_predictedPresentTimestamp FINAL)
+    Q_PROPERTY(QString cursorImageSource MEMBER m_cursorImageSource CONSTANT FINAL)
+    Q_PROPERTY(QSize cursorImageSize MEMBER m_cursorImageSize CONSTANT FINAL)
+    Q_PROPERTY(QPointF cursorPos MEMBER m_cursorPos CONSTANT FINAL)
+    Q_PROPERTY(QList<qreal> lookAheadConfig MEMBER m_lookAheadConfig CONSTANT FINAL)
+    Q_PROPERTY(qreal lookAheadOverride MEMBER m_lookAheadOverride CONSTANT FINAL)
+    Q_PROPERTY(QList<quint32> displayResolution MEMBER m_displayResolution CONSTANT FINAL)
+    Q_PROPERTY(qreal focusedDisplayDistance MEMBER m_focusedDisplayDistance CONSTANT FINAL)
+    Q_PROPERTY(qreal allDisplaysDistance MEMBER m_allDisplaysDistance CONSTANT FINAL)
+    Q_PROPERTY(qreal displaySpacing MEMBER m_displaySpacing CONSTANT FINAL)
+    Q_PROPERTY(qreal displaySize MEMBER m_displaySize CONSTANT FINAL)
+    Q_PROPERTY(qreal displayHorizontalOffset MEMBER m_displayHorizontalOffset CONSTANT FINAL)
+    Q_PROPERTY(qreal displayVerticalOffset MEMBER m_displayVerticalOffset CONSTANT FINAL)
+    Q_PROPERTY(int displayWrappingScheme MEMBER m_displayWrappingScheme CONSTANT FINAL)
+    Q_PROPERTY(qreal diagonalFOV MEMBER m_diagonalFOV CONSTANT FINAL)
+    Q_PROPERTY(qreal lensDistanceRatio MEMBER m_lensDistanceRatio CONSTANT FINAL)
+    Q_PROPERTY(bool sbsEnabled MEMBER m_sbsEnabled NOTIFY settingsChanged FINAL)
+    Q_PROPERTY(bool smoothFollowEnabled MEMBER m_smoothFollowEnabled CONSTANT FINAL)
+    Q_PROPERTY(QList<QQuaternion> smoothFollowOrigin MEMBER m_smoothFollowOrigin CONSTANT FINAL)
+    Q_PROPERTY(bool customBannerEnabled MEMBER m_customBannerEnabled CONSTANT FINAL)
+    Q_PROPERTY(int antialiasingQuality MEMBER m_antialiasingQuality NOTIFY settingsChanged FINAL)
+    Q_PROPERTY(int textureFiltering MEMBER m_textureFiltering NOTIFY settingsChanged FINAL)
+    Q_PROPERTY(qreal renderScale MEMBER m_renderScale NOTIFY settingsChanged FINAL)
+    Q_PROPERTY(bool removeVirtualDisplaysOnDisable MEMBER m_removeVirtualDisplaysOnDisable CONSTANT FINAL)
+    Q_PROPERTY(bool mirrorPhysicalDisplays MEMBER m_mirrorPhysicalDisplays CONSTANT FINAL)
+    Q_PROPERTY(bool curvedDisplay MEMBER m_curvedDisplay NOTIFY settingsChanged FINAL)
+    Q_PROPERTY(bool curvedDisplaySupported MEMBER m_curvedDisplaySupported FINAL)
+    Q_PROPERTY(bool developerMode MEMBER m_developerMode CONSTANT FINAL)
+
+public:
+    explicit MockBreezyEffect(QObject *parent = nullptr);
+
+    void setAntialiasingQuality(int quality);
+    void setTextureFiltering(int filtering);
+    void setCurvedDisplay(bool curved);
+    void setSbsEnabled(bool enabled);
+    void setDisplayResolution(const QSize &resolution);
+
+    // moves the synthetic head pose to the given time and announces the frame, like the effect's prePaintScreen
+    void prepareFrame(qint64 timeMs);
+
+    // announces a frame for the given pose, latest orientation first, instead of the synthetic one
+    void prepareFrame(const QList<QQuaternion> &orientations, quint64 poseTimestamp, qreal predictedPresentTimestamp);
+
+public Q_SLOTS:
+    QVariantMap renderStats() const { return QVariantMap(); }
+
+Q_SIGNALS:
+    void settingsChanged();
+    void lookingAtScreenNameChanged();
+    void framePrepared();
+    void displayTexturesDamaged(const QStringList &screenNames);
+
+private:
+    QQuaternion poseAt(qint64 timeMs) const;
+
+    bool m_isEnabled = true;
+    int m_effectTargetScreenIndex = -1;
+    bool m_zoomOnFocusEnabled = false;
+    int m_lookingAtScreenIndex = -1;
+    QString m_lookingAtScreenName;
+    qreal m_peripheralTextureScale = 1.0;
+    bool m_poseResetState = false;
+    bool m_poseHasPosition = false;
+    QList<QQuaternion> m_poseOrientations;
+    QVector3D m_posePosition;
+    quint32 m_poseTimeElapsedMs = 4;
+    quint64 m_poseTimestamp = 0;
+    qreal m_predictedPresentTimestamp = 0.0;
+    QString m_cursorImageSource;
+    QSize m_cursorImageSize{0, 0};
+    QPointF m_cursorPos{-1, -1};
+    QList<qreal> m_lookAheadConfig{10.0, 1.0, 0.0, 0.0};
+    qreal m_lookAheadOverride = -1.0;
+    QList<quint32> m_displayResolution{1920, 1080};
+    qreal m_focusedDisplayDistance = 0.85;
+    qreal m_allDisplaysDistance = 1.05;
+    qreal m_displaySpacing = 0.0;
+    qreal m_displaySize = 1.0;
+    qreal m_displayHorizontalOffset = 0.0;
+    qreal m_displayVerticalOffset = 0.0;
+    int m_displayWrappingScheme = 0;
+    qreal m_diagonalFOV = 46.0;
+    qreal m_lensDistanceRatio = 0.035;
+    bool m_sbsEnabled = false;
+    bool m_smoothFollowEnabled = false;
+    QList<QQuaternion> m_smoothFollowOrigin;
+    bool m_customBannerEnabled = false;
+    int m_antialiasingQuality = 0;
+    int m_textureFiltering = 0;
+    qreal m_renderScale = 1.0;
+    bool m_removeVirtualDisplaysOnDisable = true;
+    bool m_mirrorPhysicalDisplays = false;
+    bool m_curvedDisplay = false;
+    bool m_curvedDisplaySupported = false;
+    bool m_developerMode = false;
+};
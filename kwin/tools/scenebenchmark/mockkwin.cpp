@@ -0,0 +1,91 @@
+#include "mockkwin.h"
+
+#include <QQmlEngine>
+#include <QUrl>
+
+MockScreen::MockScreen(const QString &name, const QString &model, const QRect &geometry, QObject *parent)
+    : QObject(parent)
+    , m_name(name)
+    , m_model(model)
+    , m_geometry(geometry)
+{
+}
+
+MockWindow::MockWindow(const QRectF &geometry, int stackingOrder, QObject *parent)
+    : QObject(parent)
+    , m_x(geometry.x())
+    , m_y(geometry.y())
+    , m_width(geometry.width())
+    , m_height(geometry.height())
+    , m_stackingOrder(stackingOrder)
+{
+}
+
+MockWorkspace::MockWorkspace(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void MockWorkspace::addScreen(MockScreen *screen)
+{
+    screen->setParent(this);
+    m_screens.append(screen);
+}
+
+void MockWorkspace::addWindow(MockWindow *window)
+{
+    window->setParent(this);
+    m_windows.append(window);
+}
+
+QList<QObject *> MockWorkspace::screens() const
+{
+    return QList<QObject *>(m_screens.cbegin(), m_screens.cend());
+}
+
+QObject *MockWorkspace::windowForId(const QUuid &id) const
+{
+    for (MockWindow *window : m_windows) {
+        if (window->internalId() == id) return window;
+    }
+    return nullptr;
+}
+
+MockWorkspace *MockWindowModel::s_workspace = nullptr;
+
+MockWindowModel::MockWindowModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void MockWindowModel::setWorkspace(MockWorkspace *workspace)
+{
+    s_workspace = workspace;
+}
+
+int MockWindowModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !s_workspace) return 0;
+    return s_workspace->windows().count();
+}
+
+QVariant MockWindowModel::data(const QModelIndex &index, int role) const
+{
+    if (!s_workspace || !index.isValid() || index.row() >= s_workspace->windows().count() || role != Qt::UserRole) {
+        return QVariant();
+    }
+    return QVariant::fromValue<QObject *>(s_workspace->windows().at(index.row()));
+}
+
+QHash<int, QByteArray> MockWindowModel::roleNames() const
+{
+    return {{Qt::UserRole, QByteArrayLiteral("window")}};
+}
+
+void registerMockKWinTypes(MockWorkspace *workspace)
+{
+    MockWindowModel::setWorkspace(workspace);
+    qmlRegisterSingletonInstance("org.kde.kwin", 3, 0, "Workspace", workspace);
+    qmlRegisterType<MockWindowModel>("org.kde.kwin", 3, 0, "WindowModel");
+    qmlRegisterType(QUrl(QStringLiteral("qrc:/breezy/mock/WindowThumbnail.qml")), "org.kde.kwin", 3, 0, "WindowThumbnail");
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QObject>
+#include <QRect>
+#include <QUuid>
+#include <QVariant>
+
+// Just enough of the org.kde.kwin QML module for the effect's scene to load outside of KWin.
+
+class MockScreen : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString name MEMBER m_name CONSTANT)
+    Q_PROPERTY(QString model MEMBER m_model CONSTANT)
+    Q_PROPERTY(QRect geometry MEMBER m_geometry CONSTANT)
+
+public:
+    MockScreen(const QString &name, const QString &model, const QRect &geometry, QObject *parent = nullptr);
+
+    QString name() const { return m_name; }
+
+private:
+    QString m_name;
+    QString m_model;
+    QRect m_geometry;
+};
+
+class MockWindow : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QUuid internalId MEMBER m_internalId CONSTANT)
+    Q_PROPERTY(qreal x MEMBER m_x CONSTANT)
+    Q_PROPERTY(qreal y MEMBER m_y CONSTANT)
+    Q_PROPERTY(qreal width MEMBER m_width CONSTANT)
+    Q_PROPERTY(qreal height MEMBER m_height CONSTANT)
+    Q_PROPERTY(QStringList activities MEMBER m_activities CONSTANT)
+    Q_PROPERTY(QVariantList desktops MEMBER m_desktops CONSTANT)
+    Q_PROPERTY(bool onAllDesktops MEMBER m_onAllDesktops CONSTANT)
+    Q_PROPERTY(bool minimized MEMBER m_minimized CONSTANT)
+    Q_PROPERTY(int stackingOrder MEMBER m_stackingOrder CONSTANT)
+
+public:
+    MockWindow(const QRectF &geometry, int stackingOrder, QObject *parent = nullptr);
+
+    QUuid internalId() const { return m_internalId; }
+
+private:
+    QUuid m_internalId = QUuid::createUuid();
+    qreal m_x;
+    qreal m_y;
+    qreal m_width;
+    qreal m_height;
+    QStringList m_activities;
+    QVariantList m_desktops;
+    bool m_onAllDesktops = true;
+    bool m_minimized = false;
+    int m_stackingOrder;
+};
+
+class MockWorkspace : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QList<QObject *> screens READ screens CONSTANT)
+    Q_PROPERTY(QString currentActivity READ currentActivity CONSTANT)
+    Q_PROPERTY(QVariant currentDesktop READ currentDesktop CONSTANT)
+
+public:
+    explicit MockWorkspace(QObject *parent = nullptr);
+
+    void addScreen(MockScreen *screen);
+    void addWindow(MockWindow *window);
+
+    QList<QObject *> screens() const;
+    QList<MockWindow *> windows() const { return m_windows; }
+    QString currentActivity() const { return QString(); }
+    QVariant currentDesktop() const { return QVariant(); }
+
+    Q_INVOKABLE QObject *windowForId(const QUuid &id) const;
+
+private:
+    QList<MockScreen *> m_screens;
+    QList<MockWindow *> m_windows;
+};
+
+class MockWindowModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit MockWindowModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    static void setWorkspace(MockWorkspace *workspace);
+
+private:
+    static MockWorkspace *s_workspace;
+};
+
+void registerMockKWinTypes(MockWorkspace *workspace);